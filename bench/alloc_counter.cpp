@@ -0,0 +1,312 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <opencv2/core.hpp>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <link.h>
+#define ARCTICOWL_ALLOCATION_ATTRIBUTION 1
+#endif
+
+#include "alloc_counter.h"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+std::atomic<std::uint64_t> g_ownAllocations{0};
+std::atomic<bool> g_attribution{false};
+std::atomic<std::uint64_t> g_matAllocations{0};
+std::atomic<std::uint64_t> g_ownMatAllocations{0};
+
+#if defined(ARCTICOWL_ALLOCATION_ATTRIBUTION)
+
+// Load address of this executable, set when attribution is turned on.
+const void* g_programBase = nullptr;
+
+enum class Caller { Program, OpenCV, Other };
+
+Caller callerOf(const Dl_info& info)
+{
+    if (info.dli_fbase == g_programBase) {
+        return Caller::Program;
+    }
+    const char* slash = std::strrchr(info.dli_fname, '/');
+    const char* name = slash ? slash + 1 : info.dli_fname;
+    return std::strncmp(name, "libopencv_", 10) == 0 ? Caller::OpenCV : Caller::Other;
+}
+
+Caller callerAt(const void* address)
+{
+    Dl_info info;
+    if (dladdr(address, &info) == 0 || info.dli_fname == nullptr) {
+        return Caller::Other;
+    }
+    return callerOf(info);
+}
+
+// cv::Mat::create and the cv::_OutputArray methods that call it.
+bool createsMat(const Dl_info& info)
+{
+    return info.dli_sname != nullptr && (std::strncmp(info.dli_sname, "_ZN2cv3Mat6create", 17) == 0
+                                         || std::strncmp(info.dli_sname, "_ZNK2cv12_OutputArray", 21) == 0);
+}
+
+// caller is the return address of operator new. Anything that is neither
+// this executable nor OpenCV (libstdc++, libc, TBB, ...) is looked through
+// on the stack; an allocation with no such frame at all is left to the
+// libraries.
+void attribute(const void* caller)
+{
+    Caller owner = callerAt(caller);
+    if (owner == Caller::Other) {
+        constexpr int kMaxFrames = 64;
+        void* frames[kMaxFrames];
+        const int depth = backtrace(frames, kMaxFrames);
+
+        // The first frames are this file and operator new, in the program.
+        int frame = 0;
+        while (frame < depth && callerAt(frames[frame]) == Caller::Program) {
+            ++frame;
+        }
+        for (; frame < depth && owner == Caller::Other; ++frame) {
+            owner = callerAt(frames[frame]);
+        }
+    }
+
+    if (owner == Caller::Program) {
+        g_ownAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// A Mat buffer is created inside OpenCV whoever asked for it, so it is
+// attributed by the OpenCV frames between the allocation and the nearest
+// frame of this executable, leaving out Mat::create and _OutputArray. None,
+// or all from one library, means ArcticOwl created the Mat or had an OpenCV
+// function create its output: cvtColor into a member, copyTo, Mat::zeros.
+// Frames from several libraries mean a temporary one module made through
+// another, like findContours padding its input with copyMakeBorder. A
+// temporary kept within one module counts as ours, which errs towards
+// failing.
+void attributeMat()
+{
+    constexpr int kMaxFrames = 64;
+    void* frames[kMaxFrames];
+    const int depth = backtrace(frames, kMaxFrames);
+
+    // The first frames are this file, and possibly an allocator of ours
+    // falling back to the default one, in the program.
+    int frame = 0;
+    while (frame < depth && callerAt(frames[frame]) == Caller::Program) {
+        ++frame;
+    }
+
+    const void* library = nullptr;
+    bool severalLibraries = false;
+    for (; frame < depth; ++frame) {
+        Dl_info info;
+        if (dladdr(frames[frame], &info) == 0 || info.dli_fname == nullptr) {
+            continue;
+        }
+        const Caller caller = callerOf(info);
+        if (caller == Caller::Program) {
+            if (!severalLibraries) {
+                g_ownMatAllocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        if (caller == Caller::OpenCV && !createsMat(info)) {
+            severalLibraries = severalLibraries || (library != nullptr && library != info.dli_fbase);
+            library = info.dli_fbase;
+        }
+    }
+}
+
+// Wraps OpenCV's default allocator, the one every Mat without an allocator
+// of its own uses, to count the buffers it hands out. Installed while
+// attribution is on.
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    cv::MatAllocator* inner = nullptr;
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usageFlags) const override
+    {
+        // Wrapping user memory allocates no buffer.
+        if (data == nullptr) {
+            g_matAllocations.fetch_add(1, std::memory_order_relaxed);
+            attributeMat();
+        }
+        // The buffer belongs to inner, which frees it.
+        return inner->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return inner->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* data) const override { inner->deallocate(data); }
+};
+
+CountingMatAllocator g_matAllocator;
+
+int findOpenCV(dl_phdr_info* info, std::size_t, void* found)
+{
+    if (info->dlpi_name != nullptr && std::strstr(info->dlpi_name, "libopencv_core") != nullptr) {
+        *static_cast<bool*>(found) = true;
+    }
+    return 0;
+}
+
+#endif
+
+void count(const void* caller)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+#if defined(ARCTICOWL_ALLOCATION_ATTRIBUTION)
+    if (g_attribution.load(std::memory_order_relaxed)) {
+        attribute(caller);
+    }
+#else
+    (void)caller;
+#endif
+}
+
+void* allocate(std::size_t size, const void* caller)
+{
+    count(caller);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment, const void* caller)
+{
+    count(caller);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment.
+    return std::aligned_alloc(align, ((size == 0 ? 1 : size) + align - 1) / align * align);
+}
+
+}
+
+namespace ArcticOwl::Bench {
+
+std::uint64_t allocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ownAllocationCount()
+{
+    return g_ownAllocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t matAllocationCount()
+{
+    return g_matAllocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ownMatAllocationCount()
+{
+    return g_ownMatAllocations.load(std::memory_order_relaxed);
+}
+
+bool setAllocationAttribution(bool enabled)
+{
+#if defined(ARCTICOWL_ALLOCATION_ATTRIBUTION)
+    if (enabled && g_programBase == nullptr) {
+        Dl_info info;
+        bool sharedOpenCV = false;
+        dl_iterate_phdr(findOpenCV, &sharedOpenCV);
+        if (!sharedOpenCV || dladdr(reinterpret_cast<void*>(&ownAllocationCount), &info) == 0) {
+            return false;
+        }
+        g_programBase = info.dli_fbase;
+
+        // The first backtrace() loads the unwinder; do it before counting.
+        void* frame;
+        backtrace(&frame, 1);
+    }
+    if (enabled && cv::Mat::getDefaultAllocator() != &g_matAllocator) {
+        g_matAllocator.inner = cv::Mat::getDefaultAllocator();
+        cv::Mat::setDefaultAllocator(&g_matAllocator);
+    } else if (!enabled && cv::Mat::getDefaultAllocator() == &g_matAllocator) {
+        // Buffers it handed out name inner as their allocator, so they are
+        // still freed correctly.
+        cv::Mat::setDefaultAllocator(g_matAllocator.inner);
+    }
+    g_attribution.store(enabled, std::memory_order_relaxed);
+    return true;
+#else
+    return !enabled;
+#endif
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* p = allocate(size, __builtin_return_address(0))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* p = allocate(size, __builtin_return_address(0))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocateAligned(size, alignment, __builtin_return_address(0))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocateAligned(size, alignment, __builtin_return_address(0))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment, __builtin_return_address(0));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment, __builtin_return_address(0));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ArcticOwl::Bench {
+
+// Heap allocations made through operator new, by any thread, since the
+// program started. The bench executable replaces the global allocation
+// functions to count them. OpenCV pixel buffers come from cv::fastMalloc and
+// are not counted themselves, but every Mat allocation also creates its
+// UMatData with new, so a reallocated plane still shows up.
+std::uint64_t allocationCount();
+
+// The part of allocationCount() made by ArcticOwl's own code, counted while
+// attribution is on: allocations whose nearest caller in either this
+// executable or an OpenCV library is in this executable. The C++ runtime is
+// looked through, so a std::vector growing in a detector counts and a
+// UMatData made inside cv::Mat::create does not.
+std::uint64_t ownAllocationCount();
+
+// Turns attribution for ownAllocationCount() on or off. It looks up the
+// caller of every allocation and walks the stack for some, so it is off by
+// default. Returns false, and stays off, where allocations cannot be told
+// apart: without dladdr/backtrace, or with OpenCV linked statically.
+// While it is on, cv::Mat buffers are counted as well.
+bool setAllocationAttribution(bool enabled);
+
+// cv::Mat buffers allocated while attribution is on. Their memory comes from
+// cv::fastMalloc, which operator new never sees, and their UMatData from new
+// inside OpenCV, so ownAllocationCount() never sees a Mat temporary. These
+// are counted in OpenCV's default MatAllocator, which attribution wraps. A
+// Mat with an allocator of its own, such as Core::ScratchAllocator, shows up
+// when that allocator takes memory from the default one.
+std::uint64_t matAllocationCount();
+
+// The part of matAllocationCount() made for ArcticOwl's own code: Mats it
+// creates, and outputs OpenCV functions create for it, but not temporaries
+// OpenCV makes inside its primitives.
+std::uint64_t ownMatAllocationCount();
+
+}
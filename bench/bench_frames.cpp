@@ -0,0 +1,129 @@
+#include <cmath>
+#include <iostream>
+#include <mutex>
+
+#include "bench_frames.h"
+
+namespace ArcticOwl::Bench {
+
+namespace {
+
+constexpr int kSequenceLength = 8;
+
+cv::Mat renderFrame(cv::Size size, int index)
+{
+    cv::Mat frame(size, CV_8UC3);
+
+    // Static background: a vertical gradient with a brick-like texture so
+    // the texture and gradient stages see realistic edge density.
+    for (int y = 0; y < size.height; ++y) {
+        const uchar base = static_cast<uchar>(60 + 80 * y / std::max(1, size.height - 1));
+        cv::Vec3b* row = frame.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < size.width; ++x) {
+            const bool mortar = (y % 32) < 2 || ((x + ((y / 32) % 2) * 24) % 48) < 2;
+            const uchar v = mortar ? static_cast<uchar>(base / 2) : base;
+            row[x] = cv::Vec3b(v, static_cast<uchar>(v + 10), static_cast<uchar>(v + 5));
+        }
+    }
+
+    const double scale = size.height / 480.0;
+
+    // Walking figure crossing the frame from left to right.
+    const int figureWidth = static_cast<int>(40 * scale);
+    const int figureHeight = static_cast<int>(120 * scale);
+    const int figureX = (size.width - figureWidth) * index / (kSequenceLength - 1);
+    const int figureY = size.height / 2 - figureHeight / 2;
+    cv::rectangle(frame, cv::Rect(figureX, figureY, figureWidth, figureHeight), cv::Scalar(40, 40, 160), cv::FILLED);
+    cv::circle(frame, cv::Point(figureX + figureWidth / 2, figureY - figureWidth / 2), figureWidth / 2,
+               cv::Scalar(80, 120, 200), cv::FILLED);
+
+    // Flame: saturated orange/red ellipse whose size flickers per frame.
+    const cv::Point flameCenter(size.width * 3 / 4, size.height * 3 / 4);
+    const double flicker = 1.0 + 0.15 * std::sin(index * 1.7);
+    const cv::Size flameAxes(static_cast<int>(50 * scale * flicker), static_cast<int>(80 * scale * flicker));
+    cv::ellipse(frame, flameCenter, flameAxes, 0, 0, 360, cv::Scalar(0, 80, 255), cv::FILLED);
+    cv::ellipse(frame, flameCenter, cv::Size(flameAxes.width / 2, flameAxes.height / 2), 0, 0, 360,
+                cv::Scalar(40, 180, 255), cv::FILLED);
+
+    cv::Mat noise(size, CV_8UC3);
+    cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(4));
+    cv::add(frame, noise, frame);
+
+    return frame;
+}
+
+}
+
+const std::vector<cv::Mat>& syntheticSequence(cv::Size size)
+{
+    // Only the most recent resolution is kept; a 4K sequence alone is ~200 MB.
+    static std::mutex mutex;
+    static cv::Size cachedSize;
+    static std::vector<cv::Mat> cached;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cachedSize != size || cached.empty()) {
+        cv::theRNG().state = 0x0A1C0;
+        cached.clear();
+        for (int i = 0; i < kSequenceLength; ++i) {
+            cached.push_back(renderFrame(size, i));
+        }
+        cachedSize = size;
+    }
+    return cached;
+}
+
+std::shared_ptr<const Clip> loadClip(const std::string& path, std::size_t maxFrames)
+{
+    auto clip = std::make_shared<Clip>();
+    const auto slash = path.find_last_of("/\\");
+    clip->name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    try {
+        cv::VideoCapture capture(path);
+        if (!capture.isOpened()) {
+            std::cerr << "Failed to open clip: " << path << std::endl;
+            return clip;
+        }
+
+        cv::Mat frame;
+        while (clip->frames.size() < maxFrames && capture.read(frame) && !frame.empty()) {
+            clip->frames.push_back(frame.clone());
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error while loading clip " << path << ": " << e.what() << std::endl;
+    }
+
+    return clip;
+}
+
+void resolutionArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height"});
+    bench->Args({640, 480});
+    bench->Args({1280, 720});
+    bench->Args({1920, 1080});
+    bench->Args({3840, 2160});
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+cv::Size sizeFromState(const benchmark::State& state)
+{
+    return cv::Size(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+}
+
+void warmUp(Core::VideoProcessor& processor, const std::vector<cv::Mat>& frames, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        processor.processFrame(frames[static_cast<std::size_t>(i) % frames.size()]);
+    }
+}
+
+void setFrameCounters(benchmark::State& state, const cv::Mat& frame)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.total() * frame.elemSize()));
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "core/detectors.h"
+#include "core/video_processor.h"
+
+namespace ArcticOwl::Core {
+
+// Exposes the private detector stages to the benchmarks without widening
+// VideoProcessor's public interface. Each detector call starts a fresh
+// analysis context, so it pays for every plane it needs.
+struct VideoProcessorBenchAccess {
+    static std::vector<VideoProcessor::DetectionResult> runDetector(VideoProcessor& p, const std::string& name,
+                                                                    const cv::Mat& frame)
+    {
+        AnalysisContext& context = p.beginAnalysis(frame);
+        p.assignDetectorRegions(context);
+        Detector* detector = p.detector(name);
+        std::vector<VideoProcessor::DetectionResult> results;
+        if (!detector->regions().empty()) {
+            detector->detect(context, results);
+        }
+        return results;
+    }
+
+    static std::vector<VideoProcessor::DetectionResult> detectMotion(VideoProcessor& p, const cv::Mat& frame)
+    {
+        return runDetector(p, "motion", frame);
+    }
+
+    static std::vector<VideoProcessor::DetectionResult> detectIntrusion(VideoProcessor& p, const cv::Mat& frame)
+    {
+        return runDetector(p, "intrusion", frame);
+    }
+
+    static std::vector<VideoProcessor::DetectionResult> detectFire(VideoProcessor& p, const cv::Mat& frame)
+    {
+        return runDetector(p, "fire", frame);
+    }
+
+    static double calculateTextureFeature(VideoProcessor&, const cv::Mat& image)
+    {
+        return FireDetector::textureFeature(image);
+    }
+
+    static std::vector<VideoProcessor::DetectionResult> detectEquipmentFailure(VideoProcessor& p, const cv::Mat& frame)
+    {
+        return runDetector(p, "equipment", frame);
+    }
+};
+
+}
+
+namespace ArcticOwl::Bench {
+
+struct Clip {
+    std::string name;
+    std::vector<cv::Mat> frames;
+};
+
+// Deterministic synthetic scene: textured static background, a walking
+// figure crossing the central intrusion area and a flickering flame blob.
+// Frames are generated once per resolution and cycled by the benchmarks.
+const std::vector<cv::Mat>& syntheticSequence(cv::Size size);
+
+// Loads up to maxFrames decoded frames; returns an empty clip on failure.
+std::shared_ptr<const Clip> loadClip(const std::string& path, std::size_t maxFrames);
+
+// 480p, 720p, 1080p and 4K as {width, height} argument pairs.
+void resolutionArguments(benchmark::internal::Benchmark* bench);
+
+cv::Size sizeFromState(const benchmark::State& state);
+
+// Feeds frames through the processor so background models have settled
+// before the timed region starts.
+void warmUp(Core::VideoProcessor& processor, const std::vector<cv::Mat>& frames, int count);
+
+void setFrameCounters(benchmark::State& state, const cv::Mat& frame);
+
+// Registers the whole-pipeline and per-detector benchmarks for a recorded clip.
+void registerClipBenchmarks(const std::shared_ptr<const Clip>& clip);
+
+}
\ No newline at end of file
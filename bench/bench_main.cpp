@@ -0,0 +1,77 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_frames.h"
+
+namespace {
+
+constexpr std::size_t kMaxClipFrames = 120;
+constexpr const char* kClipOption = "--clip=";
+
+bool hasFormatFlag(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--benchmark_format", 18) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+// Recorded clips come from repeated --clip=<file> arguments and from
+// ARCTICOWL_BENCH_CLIPS (colon-separated). Output defaults to JSON on stdout
+// so results can be diffed between builds; pass --benchmark_format=console
+// for the human-readable table.
+int main(int argc, char** argv)
+{
+    std::vector<std::string> clipPaths;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0 && std::strncmp(argv[i], kClipOption, std::strlen(kClipOption)) == 0) {
+            clipPaths.emplace_back(argv[i] + std::strlen(kClipOption));
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (const char* env = std::getenv("ARCTICOWL_BENCH_CLIPS")) {
+        std::stringstream paths(env);
+        std::string path;
+        while (std::getline(paths, path, ':')) {
+            if (!path.empty()) {
+                clipPaths.push_back(path);
+            }
+        }
+    }
+
+    static char jsonFormat[] = "--benchmark_format=json";
+    if (!hasFormatFlag(static_cast<int>(args.size()), args.data())) {
+        args.push_back(jsonFormat);
+    }
+
+    for (const auto& path : clipPaths) {
+        auto clip = ArcticOwl::Bench::loadClip(path, kMaxClipFrames);
+        if (clip->frames.empty()) {
+            std::cerr << "Skipping clip without frames: " << path << std::endl;
+            continue;
+        }
+        ArcticOwl::Bench::registerClipBenchmarks(clip);
+    }
+
+    int benchArgc = static_cast<int>(args.size());
+    args.push_back(nullptr);
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data())) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
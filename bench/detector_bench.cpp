@@ -0,0 +1,680 @@
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "alloc_counter.h"
+#include "bench_frames.h"
+#include "core/background_model.h"
+#include "core/dnn_detector.h"
+#include "core/fire_color_mask.h"
+#include "core/gradient_energy.h"
+#include "core/thread_pool.h"
+
+namespace ArcticOwl::Bench {
+
+namespace {
+
+using Core::VideoProcessor;
+using Core::VideoProcessorBenchAccess;
+
+constexpr int kWarmUpFrames = 30;
+
+template <typename Stage>
+void runFrameStage(benchmark::State& state, const std::vector<cv::Mat>& frames, Stage stage)
+{
+    if (frames.empty()) {
+        state.SkipWithError("no frames");
+        return;
+    }
+
+    VideoProcessor processor;
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        stage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void processFrameStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    auto results = processor.processFrame(frame);
+    benchmark::DoNotOptimize(results);
+}
+
+void detectMotionStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    auto results = VideoProcessorBenchAccess::detectMotion(processor, frame);
+    benchmark::DoNotOptimize(results);
+}
+
+void detectIntrusionStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    auto results = VideoProcessorBenchAccess::detectIntrusion(processor, frame);
+    benchmark::DoNotOptimize(results);
+}
+
+void detectFireStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    auto results = VideoProcessorBenchAccess::detectFire(processor, frame);
+    benchmark::DoNotOptimize(results);
+}
+
+void textureFeatureStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    double texture = VideoProcessorBenchAccess::calculateTextureFeature(processor, frame);
+    benchmark::DoNotOptimize(texture);
+}
+
+void equipmentFailureStage(VideoProcessor& processor, const cv::Mat& frame)
+{
+    auto results = VideoProcessorBenchAccess::detectEquipmentFailure(processor, frame);
+    benchmark::DoNotOptimize(results);
+}
+
+void BM_ProcessFrame(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), processFrameStage);
+}
+
+void BM_DetectMotion(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), detectMotionStage);
+}
+
+void BM_DetectIntrusion(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), detectIntrusionStage);
+}
+
+void BM_DetectFire(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), detectFireStage);
+}
+
+void BM_CalculateTextureFeature(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), textureFeatureStage);
+}
+
+void BM_DetectEquipmentFailure(benchmark::State& state)
+{
+    runFrameStage(state, syntheticSequence(sizeFromState(state)), equipmentFailureStage);
+}
+
+// Arguments: width, height, analysis scale in percent.
+void BM_ProcessFrameScaled(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const double scale = static_cast<double>(state.range(2)) / 100.0;
+
+    VideoProcessor processor;
+    processor.setAnalysisScale(scale);
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+// Same as BM_ProcessFrame, with independent detectors spread over a pool.
+// Compare the two to see the per-frame latency gained on this machine.
+void BM_ProcessFrameParallel(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    Core::ThreadPool pool;
+    VideoProcessor processor;
+    processor.setThreadPool(&pool);
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+// Arguments: width, height, BackgroundModel::Engine.
+void BM_BackgroundModel(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const auto engine = static_cast<Core::BackgroundModel::Engine>(state.range(2));
+    state.SetLabel(Core::BackgroundModel::engineName(engine));
+
+    auto model = Core::BackgroundModel::create(engine);
+    cv::Mat mask;
+    for (int i = 0; i < kWarmUpFrames; ++i) {
+        model->apply(frames[static_cast<std::size_t>(i) % frames.size()], mask);
+    }
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        model->apply(frames[index++ % frames.size()], mask);
+        benchmark::DoNotOptimize(mask.data);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+// Arguments: width, height, BackgroundModel::Engine.
+void BM_ProcessFrameEngine(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const auto engine = static_cast<Core::BackgroundModel::Engine>(state.range(2));
+    state.SetLabel(Core::BackgroundModel::engineName(engine));
+
+    VideoProcessor processor;
+    processor.setBackgroundEngine(engine);
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void backgroundEngineArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "engine"});
+    for (const auto engine : {Core::BackgroundModel::MOG2_KNN, Core::BackgroundModel::MOG2,
+                              Core::BackgroundModel::KNN, Core::BackgroundModel::RUNNING_AVERAGE}) {
+        bench->Args({640, 480, engine});
+        bench->Args({1280, 720, engine});
+        bench->Args({1920, 1080, engine});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// The chain fireColorMask replaced; kept as the reference it must match.
+void referenceFireColorMask(const cv::Mat& frame, cv::Mat& mask)
+{
+    cv::Mat hsv, lower, upper;
+    cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, cv::Scalar(0, 100, 100), cv::Scalar(15, 255, 255), lower);
+    cv::inRange(hsv, cv::Scalar(160, 100, 100), cv::Scalar(180, 255, 255), upper);
+    cv::bitwise_or(lower, upper, mask);
+}
+
+bool fireColorMaskMatches(const cv::Mat& frame)
+{
+    cv::Mat fused, expected;
+    Core::fireColorMask(frame, fused);
+    referenceFireColorMask(frame, expected);
+    return cv::countNonZero(fused != expected) == 0;
+}
+
+// Every BGR value once, as a 4096x4096 image; checked a single time per run.
+bool fireColorMaskMatchesAllColors()
+{
+    static const bool matches = []() {
+        cv::Mat colors(4096, 4096, CV_8UC3);
+        for (int y = 0; y < colors.rows; ++y) {
+            cv::Vec3b* row = colors.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < colors.cols; ++x) {
+                const int value = y * colors.cols + x;
+                row[x] = cv::Vec3b(static_cast<uchar>(value), static_cast<uchar>(value >> 8),
+                                   static_cast<uchar>(value >> 16));
+            }
+        }
+        return fireColorMaskMatches(colors);
+    }();
+    return matches;
+}
+
+// Fails instead of timing if the fused kernel disagrees with the reference
+// chain on any colour or on any pixel of the sequence.
+void BM_FireColorMask(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    bool matches = fireColorMaskMatchesAllColors();
+    for (const auto& frame : frames) {
+        matches = matches && fireColorMaskMatches(frame);
+    }
+    if (!matches) {
+        state.SkipWithError("fireColorMask differs from cvtColor/inRange");
+        return;
+    }
+
+    cv::Mat mask;
+    std::size_t index = 0;
+    for (auto _ : state) {
+        Core::fireColorMask(frames[index++ % frames.size()], mask);
+        benchmark::DoNotOptimize(mask.data);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void BM_FireColorMaskReference(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    cv::Mat mask;
+    std::size_t index = 0;
+    for (auto _ : state) {
+        referenceFireColorMask(frames[index++ % frames.size()], mask);
+        benchmark::DoNotOptimize(mask.data);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+// Overlapping candidate boxes spread over the middle of the frame, as a
+// flickering fire breaks into many blobs.
+std::vector<cv::Rect> candidateBoxes(cv::Size size, int count)
+{
+    std::vector<cv::Rect> boxes;
+    const cv::Size box(size.width / 4, size.height / 4);
+    for (int i = 0; i < count; ++i) {
+        const int x = size.width / 4 + (i * 37 % 16) * size.width / 32;
+        const int y = size.height / 4 + (i * 23 % 16) * size.height / 32;
+        boxes.emplace_back(cv::Point(x, y), box);
+    }
+    return boxes;
+}
+
+// The per-candidate chain the map replaces.
+double referenceMeanGradient(const cv::Mat& image)
+{
+    cv::Mat gray, gradX, gradY, magnitude;
+    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    cv::Sobel(gray, gradX, CV_64F, 1, 0, 3);
+    cv::Sobel(gray, gradY, CV_64F, 0, 1, 3);
+    cv::magnitude(gradX, gradY, magnitude);
+    return cv::mean(magnitude)[0];
+}
+
+// Boxes are compared with the whole-frame Sobel magnitude, whose borders are
+// the neighbouring pixels just as in the map.
+bool gradientEnergyMatches(const cv::Mat& frame, const std::vector<cv::Rect>& boxes)
+{
+    cv::Mat gray, gradX, gradY, magnitude;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::Sobel(gray, gradX, CV_64F, 1, 0, 3);
+    cv::Sobel(gray, gradY, CV_64F, 0, 1, 3);
+    cv::magnitude(gradX, gradY, magnitude);
+
+    Core::GradientEnergyMap map;
+    cv::Rect area = boxes.front();
+    for (const auto& box : boxes) {
+        area |= box;
+    }
+    map.compute(frame, area);
+    for (const auto& box : boxes) {
+        if (std::abs(map.meanMagnitude(box) - cv::mean(magnitude(box))[0]) > 1e-3) {
+            return false;
+        }
+    }
+
+    const cv::Rect whole(0, 0, frame.cols, frame.rows);
+    map.compute(frame, whole);
+    return std::abs(map.meanMagnitude(whole) - referenceMeanGradient(frame)) <= 1e-3;
+}
+
+// Arguments: width, height, candidate count. One map over the candidates'
+// union, then four reads per candidate; the time should barely move with the
+// count. Fails instead of timing if a mean differs from cv::Sobel's.
+void BM_GradientEnergyMap(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const auto boxes = candidateBoxes(frames.front().size(), static_cast<int>(state.range(2)));
+
+    for (const auto& frame : frames) {
+        if (!gradientEnergyMatches(frame, boxes)) {
+            state.SkipWithError("GradientEnergyMap differs from Sobel/magnitude");
+            return;
+        }
+    }
+
+    cv::Rect area = boxes.front();
+    for (const auto& box : boxes) {
+        area |= box;
+    }
+
+    Core::GradientEnergyMap map;
+    std::size_t index = 0;
+    for (auto _ : state) {
+        map.compute(frames[index++ % frames.size()], area);
+        double texture = 0.0;
+        for (const auto& box : boxes) {
+            texture += map.meanMagnitude(box);
+        }
+        benchmark::DoNotOptimize(texture);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void BM_GradientEnergyReference(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const auto boxes = candidateBoxes(frames.front().size(), static_cast<int>(state.range(2)));
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        const cv::Mat& frame = frames[index++ % frames.size()];
+        double texture = 0.0;
+        for (const auto& box : boxes) {
+            texture += referenceMeanGradient(frame(box));
+        }
+        benchmark::DoNotOptimize(texture);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void candidateCountArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "candidates"});
+    for (const int64_t candidates : {1, 8, 32}) {
+        bench->Args({1920, 1080, candidates});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// Arguments: width, height, cameras. Each iteration submits one frame per
+// camera and waits for all of their objects, so the time is one batched
+// forward pass; items are frames. Needs a YOLO ONNX model named by
+// ARCTICOWL_BENCH_ONNX.
+void BM_ObjectDetectionBatched(benchmark::State& state)
+{
+    const char* modelPath = std::getenv("ARCTICOWL_BENCH_ONNX");
+    if (!modelPath || !*modelPath) {
+        state.SkipWithError("set ARCTICOWL_BENCH_ONNX to a YOLO ONNX model");
+        return;
+    }
+
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const int cameras = static_cast<int>(state.range(2));
+
+    Core::DnnInferenceQueue::Options options;
+    options.modelPath = modelPath;
+    options.maxBatch = cameras;
+    options.batchWindowMs = 50;
+    auto queue = Core::DnnInferenceQueue::create(options);
+    if (!queue) {
+        state.SkipWithError("cannot load the ARCTICOWL_BENCH_ONNX model");
+        return;
+    }
+
+    std::vector<std::shared_ptr<Core::DnnInferenceQueue::Client>> clients;
+    for (int camera = 0; camera < cameras; ++camera) {
+        clients.push_back(queue->connect());
+    }
+
+    std::vector<Core::DnnInferenceQueue::Object> objects;
+    std::size_t index = 0;
+    for (auto _ : state) {
+        for (auto& client : clients) {
+            client->submit(frames[index++ % frames.size()]);
+        }
+        for (auto& client : clients) {
+            while (!client->takeResults(objects)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    const cv::Mat& frame = frames.front();
+    state.SetItemsProcessed(state.iterations() * cameras);
+    state.SetBytesProcessed(state.iterations() * cameras * static_cast<int64_t>(frame.total() * frame.elemSize()));
+}
+
+void cameraCountArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "cameras"});
+    for (const int64_t cameras : {1, 4, 16}) {
+        bench->Args({1280, 720, cameras});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// Arguments: width, height, static scene. A static scene repeats one frame,
+// so after warm-up nothing is foreground and gated fire detection only runs
+// its periodic full scan.
+void BM_ProcessFrameFireGated(benchmark::State& state)
+{
+    const auto& sequence = syntheticSequence(sizeFromState(state));
+    const std::vector<cv::Mat> frames = state.range(2) ? std::vector<cv::Mat>{sequence.front()} : sequence;
+
+    VideoProcessor processor;
+    processor.setDetectorSchedule("fire", {true, 50});
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void fireGatingArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "static"});
+    for (const int64_t still : {0, 1}) {
+        bench->Args({1280, 720, still});
+        bench->Args({1920, 1080, still});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// Arguments: width, height, detection stride.
+void BM_ProcessFrameStride(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    VideoProcessor processor;
+    processor.setDetectionStride(static_cast<int>(state.range(2)));
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void detectionStrideArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "stride"});
+    for (const int64_t stride : {1, 2, 4}) {
+        bench->Args({1280, 720, stride});
+        bench->Args({1920, 1080, stride});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// Heap allocations per frame of the full default pipeline. "allocations"
+// counts all of them, including those OpenCV makes inside its primitives,
+// and is meant to be compared between builds; "own_allocations" is the part
+// made by ArcticOwl's code, which the processor_allocations test holds at
+// zero on a repeating scene. It is left out where allocations cannot be
+// attributed.
+void BM_ProcessFrameAllocations(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+    const bool attributed = setAllocationAttribution(true);
+
+    VideoProcessor processor;
+    std::vector<VideoProcessor::DetectionResult> results;
+    for (int i = 0; i < kWarmUpFrames; ++i) {
+        processor.processFrame(frames[static_cast<std::size_t>(i) % frames.size()], results);
+    }
+
+    const std::uint64_t before = allocationCount();
+    const std::uint64_t ownBefore = ownAllocationCount();
+    const std::uint64_t matsBefore = matAllocationCount();
+    const std::uint64_t ownMatsBefore = ownMatAllocationCount();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processor.processFrame(frames[index++ % frames.size()], results);
+        benchmark::DoNotOptimize(results.data());
+    }
+    const std::uint64_t allocations = allocationCount() - before;
+    const std::uint64_t ownAllocations = ownAllocationCount() - ownBefore;
+    const std::uint64_t matAllocations = matAllocationCount() - matsBefore;
+    const std::uint64_t ownMatAllocations = ownMatAllocationCount() - ownMatsBefore;
+    setAllocationAttribution(false);
+
+    state.counters["allocations"] =
+        benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    if (attributed) {
+        state.counters["own_allocations"] =
+            benchmark::Counter(static_cast<double>(ownAllocations), benchmark::Counter::kAvgIterations);
+        state.counters["mat_allocations"] =
+            benchmark::Counter(static_cast<double>(matAllocations), benchmark::Counter::kAvgIterations);
+        state.counters["own_mat_allocations"] =
+            benchmark::Counter(static_cast<double>(ownMatAllocations), benchmark::Counter::kAvgIterations);
+    }
+    setFrameCounters(state, frames.front());
+}
+
+// count zones: a strip of include quads across the frame, every fourth one
+// an exclusion.
+std::vector<Core::Zone> benchZones(int count)
+{
+    std::vector<Core::Zone> zones;
+    for (int i = 0; i < count; ++i) {
+        const float x0 = static_cast<float>(i) / count;
+        const float x1 = static_cast<float>(i + 1) / count;
+        Core::Zone zone;
+        zone.kind = (i % 4 == 3) ? Core::Zone::EXCLUDE : Core::Zone::INCLUDE;
+        zone.polygon = {{x0, 0.2f}, {x1, 0.1f}, {x1, 0.9f}, {x0, 0.8f}};
+        zones.push_back(zone);
+    }
+    return zones;
+}
+
+// Arguments: width, height, zone count. Per-frame cost should not depend on
+// the zone count.
+void BM_DetectIntrusionZones(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    VideoProcessor processor;
+    processor.setZones(benchZones(static_cast<int>(state.range(2))));
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        detectIntrusionStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void zoneCountArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "zones"});
+    for (const int64_t zones : {0, 1, 16, 64}) {
+        bench->Args({1920, 1080, zones});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+// Arguments: width, height, morphology scale in percent.
+void BM_ProcessFrameMorphology(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    VideoProcessor processor;
+    processor.setMorphologyScale(static_cast<double>(state.range(2)) / 100.0);
+    warmUp(processor, frames, kWarmUpFrames);
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        processFrameStage(processor, frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+}
+
+void morphologyScaleArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "morph_pct"});
+    for (const int64_t scale : {100, 50}) {
+        bench->Args({1280, 720, scale});
+        bench->Args({1920, 1080, scale});
+        bench->Args({3840, 2160, scale});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+void analysisScaleArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "scale_pct"});
+    for (const int64_t scale : {100, 50, 25}) {
+        bench->Args({1280, 720, scale});
+        bench->Args({1920, 1080, scale});
+        bench->Args({3840, 2160, scale});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+}
+
+BENCHMARK(BM_ProcessFrame)->Apply(resolutionArguments);
+BENCHMARK(BM_ProcessFrameParallel)->Apply(resolutionArguments);
+BENCHMARK(BM_ProcessFrameScaled)->Apply(analysisScaleArguments);
+BENCHMARK(BM_ProcessFrameStride)->Apply(detectionStrideArguments);
+BENCHMARK(BM_ProcessFrameAllocations)->Apply(resolutionArguments);
+BENCHMARK(BM_ProcessFrameFireGated)->Apply(fireGatingArguments);
+BENCHMARK(BM_ProcessFrameMorphology)->Apply(morphologyScaleArguments);
+BENCHMARK(BM_ProcessFrameEngine)->Apply(backgroundEngineArguments);
+BENCHMARK(BM_BackgroundModel)->Apply(backgroundEngineArguments);
+BENCHMARK(BM_DetectMotion)->Apply(resolutionArguments);
+BENCHMARK(BM_DetectIntrusion)->Apply(resolutionArguments);
+BENCHMARK(BM_DetectIntrusionZones)->Apply(zoneCountArguments);
+BENCHMARK(BM_DetectFire)->Apply(resolutionArguments);
+BENCHMARK(BM_FireColorMask)->Apply(resolutionArguments);
+BENCHMARK(BM_FireColorMaskReference)->Apply(resolutionArguments);
+BENCHMARK(BM_CalculateTextureFeature)->Apply(resolutionArguments);
+BENCHMARK(BM_GradientEnergyMap)->Apply(candidateCountArguments);
+BENCHMARK(BM_GradientEnergyReference)->Apply(candidateCountArguments);
+BENCHMARK(BM_DetectEquipmentFailure)->Apply(resolutionArguments);
+BENCHMARK(BM_ObjectDetectionBatched)->Apply(cameraCountArguments);
+
+void registerClipBenchmarks(const std::shared_ptr<const Clip>& clip)
+{
+    if (!clip || clip->frames.empty()) {
+        return;
+    }
+
+    const auto add = [&clip](const std::string& name, void (*stage)(VideoProcessor&, const cv::Mat&)) {
+        benchmark::RegisterBenchmark((name + "/clip:" + clip->name).c_str(),
+                                     [clip, stage](benchmark::State& state) {
+                                         runFrameStage(state, clip->frames, stage);
+                                     })
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    };
+
+    add("BM_ProcessFrame", processFrameStage);
+    add("BM_DetectMotion", detectMotionStage);
+    add("BM_DetectIntrusion", detectIntrusionStage);
+    add("BM_DetectFire", detectFireStage);
+    add("BM_CalculateTextureFeature", textureFeatureStage);
+    add("BM_DetectEquipmentFailure", equipmentFailureStage);
+}
+
+}
\ No newline at end of file
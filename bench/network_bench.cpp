@@ -0,0 +1,91 @@
+#include <array>
+#include <chrono>
+#include <thread>
+#include <boost/asio.hpp>
+
+#include "bench_frames.h"
+#include "modules/network/network_server.h"
+
+namespace ArcticOwl::Bench {
+
+namespace {
+
+// Local stream client that reads and discards everything, so broadcastFrame
+// is measured against a client that keeps up.
+class DrainingClient {
+public:
+    explicit DrainingClient(int port)
+        : m_socket(m_ioContext)
+    {
+        m_socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(),
+                                                        static_cast<unsigned short>(port)));
+        read();
+        m_thread = std::thread([this]() { m_ioContext.run(); });
+    }
+
+    ~DrainingClient()
+    {
+        m_ioContext.stop();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    void read()
+    {
+        m_socket.async_read_some(boost::asio::buffer(m_buffer), [this](boost::system::error_code ec, std::size_t) {
+            if (!ec) {
+                read();
+            }
+        });
+    }
+
+    boost::asio::io_context m_ioContext;
+    boost::asio::ip::tcp::socket m_socket;
+    std::array<char, 64 * 1024> m_buffer{};
+    std::thread m_thread;
+};
+
+// Encodes and queues a frame the way the processing worker's sink does.
+// Arguments: width, height, number of connected clients.
+void BM_BroadcastFrame(benchmark::State& state)
+{
+    const auto& frames = syntheticSequence(sizeFromState(state));
+
+    Modules::Network::NetworkServer server(0);
+    server.startNetworkSystem();
+
+    std::vector<std::unique_ptr<DrainingClient>> clients;
+    for (int64_t i = 0; i < state.range(2); ++i) {
+        clients.push_back(std::make_unique<DrainingClient>(server.port()));
+    }
+    // Let the server thread accept the connections before timing.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::size_t index = 0;
+    for (auto _ : state) {
+        server.broadcastFrame(frames[index++ % frames.size()]);
+    }
+
+    setFrameCounters(state, frames.front());
+
+    server.stopNetworkSystem();
+}
+
+void broadcastArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"width", "height", "clients"});
+    for (const auto& size : {std::array<int64_t, 2>{640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160}}) {
+        bench->Args({size[0], size[1], 0});
+        bench->Args({size[0], size[1], 1});
+    }
+    bench->Unit(benchmark::kMillisecond);
+    bench->UseRealTime();
+}
+
+}
+
+BENCHMARK(BM_BroadcastFrame)->Apply(broadcastArguments);
+
+}
\ No newline at end of file
@@ -1,14 +1,33 @@
 import socket, struct
 
+HANDSHAKE = b'ARCTICOWL/2'
+
 s = socket.create_connection(("127.0.0.1", 8080))
 
-size_bytes = s.recv(4)
-size = struct.unpack('<I', size_bytes)[0]
 
-buf = bytearray()
-while len(buf) < size:
-    chunk = s.recv(size - len(buf))
-    if not chunk:
+def read_message(typed):
+    header = s.recv(5 if typed else 4, socket.MSG_WAITALL)
+    size = struct.unpack('<I', header[:4])[0]
+    kind = header[4] if typed else None
+
+    buf = bytearray()
+    while len(buf) < size:
+        chunk = s.recv(size - len(buf))
+        if not chunk:
+            break
+        buf.extend(chunk)
+    return kind, bytes(buf)
+
+
+# Ask for typed messages; until the server echoes the handshake, messages
+# still come without the type byte.
+s.sendall(HANDSHAKE + b'\n')
+while read_message(False)[1] != HANDSHAKE:
+    pass
+
+# Skip alerts (type 1) and detection JSON (type 2) until the first frame.
+while True:
+    kind, buf = read_message(True)
+    if kind == 0:
+        open('frame.jpg', 'wb').write(buf)
         break
-    buf.extend(chunk)
-open('frame.jpg', 'wb').write(buf)
\ No newline at end of file
@@ -136,7 +136,7 @@
         <translation>设置已更新</translation>
     </message>
     <message>
-        <source>The network port will take effect the next time the system starts.</source>
+        <source>The network ports will take effect the next time the system starts.</source>
         <translation>网络端口将在下次启动系统时生效。</translation>
     </message>
     <message>
@@ -219,5 +219,61 @@ Project site: github.com/polarours/ArcticOwl</source>
         <source>RTMP stream URL cannot be empty.</source>
         <translation>RTMP流地址不能为空。</translation>
     </message>
+    <message>
+        <source>Add Camera</source>
+        <translation>添加摄像头</translation>
+    </message>
+    <message>
+        <source>Remove Camera</source>
+        <translation>移除摄像头</translation>
+    </message>
+    <message>
+        <source>FPS</source>
+        <translation>帧率</translation>
+    </message>
+    <message>
+        <source>Idle</source>
+        <translation>空闲</translation>
+    </message>
+    <message>
+        <source>Running</source>
+        <translation>运行中</translation>
+    </message>
+    <message>
+        <source>Failed</source>
+        <translation>失败</translation>
+    </message>
+    <message>
+        <source>Stopped</source>
+        <translation>已停止</translation>
+    </message>
+    <message>
+        <source>Metrics Port:</source>
+        <translation>指标端口：</translation>
+    </message>
+    <message>
+        <source>Disabled</source>
+        <translation>已禁用</translation>
+    </message>
+    <message>
+        <source>Reconnecting</source>
+        <translation>重连中</translation>
+    </message>
+    <message>
+        <source>Analysis Resolution:</source>
+        <translation>分析分辨率：</translation>
+    </message>
+    <message>
+        <source>Native resolution</source>
+        <translation>原始分辨率</translation>
+    </message>
+    <message>
+        <source>1/2 resolution</source>
+        <translation>1/2 分辨率</translation>
+    </message>
+    <message>
+        <source>1/4 resolution</source>
+        <translation>1/4 分辨率</translation>
+    </message>
 </context>
 </TS>
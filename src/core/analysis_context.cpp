@@ -0,0 +1,128 @@
+#include <cstddef>
+
+#include "analysis_context.h"
+
+namespace ArcticOwl::Core {
+
+void AnalysisContext::reset(const cv::Mat& frame, double areaScale, const cv::Mat& morphKernel,
+                            double morphologyScale)
+{
+    m_frame = frame;
+    m_areaScale = areaScale;
+    m_morphKernel = morphKernel;
+    m_morphologyScale = morphologyScale;
+    m_zones.compile(frame.size());
+
+    // Only the flags are cleared; the planes keep their buffers.
+    for (Plane* plane : {&m_foregroundPlane, &m_blobsPlane, &m_regionsPlane, &m_grayPlane, &m_hsvPlane}) {
+        std::lock_guard<std::mutex> lock(plane->mutex);
+        plane->ready = false;
+    }
+}
+
+void AnalysisContext::releaseFrame()
+{
+    std::lock_guard<std::mutex> lock(m_grayPlane.mutex);
+    if (m_gray.data == m_frame.data) {
+        m_gray.release();
+        m_grayPlane.ready = false;
+    }
+    m_frame.release();
+}
+
+const cv::Mat& AnalysisContext::foregroundMask()
+{
+    ensure(m_foregroundPlane, [this]() {
+        if (m_foregroundModel) {
+            m_foregroundModel(m_frame, m_foregroundMask);
+            m_foregroundBlobs.clean(m_foregroundMask, m_morphKernel, m_morphologyScale);
+            // Applied after cleanup so closing cannot grow blobs back into
+            // an excluded area.
+            if (!m_zones.excludeMask().empty()) {
+                m_foregroundMask.setTo(cv::Scalar::all(0), m_zones.excludeMask());
+            }
+        } else {
+            m_foregroundMask.create(m_frame.size(), CV_8UC1);
+            m_foregroundMask.setTo(cv::Scalar::all(0));
+        }
+    });
+    return m_foregroundMask;
+}
+
+const std::vector<AnalysisContext::Blob>& AnalysisContext::foregroundBlobs()
+{
+    ensure(m_blobsPlane, [this]() {
+        m_foregroundBlobs.extract(foregroundMask(), analysisArea(kMinBlobArea));
+    });
+    return m_foregroundBlobs.blobs();
+}
+
+const std::vector<cv::Rect>& AnalysisContext::dirtyRegions()
+{
+    ensure(m_regionsPlane, [this]() {
+        const cv::Mat& mask = foregroundMask();
+        const cv::Rect plane(0, 0, mask.cols, mask.rows);
+
+        m_dirtyTiles.create((mask.rows + kTileSize - 1) / kTileSize, (mask.cols + kTileSize - 1) / kTileSize,
+                            CV_8UC1);
+        for (int ty = 0; ty < m_dirtyTiles.rows; ++ty) {
+            uchar* row = m_dirtyTiles.ptr<uchar>(ty);
+            for (int tx = 0; tx < m_dirtyTiles.cols; ++tx) {
+                const cv::Rect tile = cv::Rect(tx * kTileSize, ty * kTileSize, kTileSize, kTileSize) & plane;
+                row[tx] = cv::countNonZero(mask(tile)) > 0 ? 255 : 0;
+            }
+        }
+
+        // One tile of margin catches the parts of an object the foreground
+        // mask missed at its edges.
+        // The kernel is kept: with an empty one, dilate builds it per call.
+        cv::dilate(m_dirtyTiles, m_dirtyTiles, m_tileKernel);
+
+        m_dirtyRegions.clear();
+        for (const auto& blob : m_tileBlobs.extract(m_dirtyTiles)) {
+            const cv::Rect& tiles = blob.boundingBox;
+            m_dirtyRegions.push_back(cv::Rect(tiles.x * kTileSize, tiles.y * kTileSize,
+                                              tiles.width * kTileSize, tiles.height * kTileSize) & plane);
+        }
+
+        // Boxes of interlocking components can overlap; merge them so no
+        // pixel is examined (and reported) twice.
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (std::size_t i = 0; i < m_dirtyRegions.size() && !merged; ++i) {
+                for (std::size_t j = i + 1; j < m_dirtyRegions.size(); ++j) {
+                    if ((m_dirtyRegions[i] & m_dirtyRegions[j]).area() > 0) {
+                        m_dirtyRegions[i] |= m_dirtyRegions[j];
+                        m_dirtyRegions.erase(m_dirtyRegions.begin() + static_cast<std::ptrdiff_t>(j));
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    return m_dirtyRegions;
+}
+
+const cv::Mat& AnalysisContext::gray()
+{
+    ensure(m_grayPlane, [this]() {
+        if (m_frame.channels() == 3) {
+            cv::cvtColor(m_frame, m_gray, cv::COLOR_BGR2GRAY);
+        } else {
+            m_gray = m_frame;
+        }
+    });
+    return m_gray;
+}
+
+const cv::Mat& AnalysisContext::hsv()
+{
+    ensure(m_hsvPlane, [this]() {
+        cv::cvtColor(m_frame, m_hsv, cv::COLOR_BGR2HSV);
+    });
+    return m_hsv;
+}
+
+}
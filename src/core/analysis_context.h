@@ -0,0 +1,114 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "blob_extractor.h"
+#include "zone_map.h"
+
+namespace ArcticOwl::Core {
+
+// Per-frame inputs shared by the detectors. Every plane is computed on first
+// use and at most once per frame, so detectors that need the same foreground
+// mask or colour conversion no longer repeat it (or feed the background
+// models the same frame twice). Accessors are safe to call from several
+// threads; planes keep their allocations from one frame to the next.
+class AnalysisContext {
+public:
+    // A foreground region of the analysis plane. Areas are in analysis-plane
+    // pixels, like the thresholds from analysisArea().
+    using Blob = BlobExtractor::Blob;
+
+    // Smallest blob, in full-resolution pixels of outline area, that motion,
+    // intrusion, and fire detection report. Smaller foreground blobs are not
+    // traced and keep an area of 0.
+    static constexpr double kMinBlobArea = 500.0;
+
+    // Writes the raw binary foreground mask of frame into mask and updates
+    // the background model; called at most once per frame. The context
+    // cleans the mask afterwards.
+    using ForegroundModel = std::function<void(const cv::Mat& frame, cv::Mat& mask)>;
+
+    AnalysisContext() = default;
+    AnalysisContext(const AnalysisContext&) = delete;
+    AnalysisContext& operator=(const AnalysisContext&) = delete;
+
+    void setForegroundModel(ForegroundModel model) { m_foregroundModel = std::move(model); }
+
+    // Starts a new frame. areaScale converts full-resolution areas to
+    // analysis-plane areas; morphKernel is the mask cleanup kernel sized for
+    // the analysis plane, applied at morphologyScale of it (see
+    // BlobExtractor::clean). Recompiles the zones if the plane size changed.
+    void reset(const cv::Mat& frame, double areaScale, const cv::Mat& morphKernel, double morphologyScale = 1.0);
+    // Drops the references to the frame's pixels so a pooled buffer can be
+    // recycled while the derived planes keep their allocations.
+    void releaseFrame();
+
+    // Edge of the square tiles behind dirtyRegions(), in analysis pixels.
+    static constexpr int kTileSize = 32;
+
+    const cv::Mat& frame() const { return m_frame; }
+    double analysisArea(double fullResolutionArea) const { return fullResolutionArea * m_areaScale; }
+    const cv::Mat& morphKernel() const { return m_morphKernel; }
+    double morphologyScale() const { return m_morphologyScale; }
+    // The camera's zones, compiled for the analysis plane. Change them only
+    // between frames.
+    ZoneMap& zones() { return m_zones; }
+    const ZoneMap& zones() const { return m_zones; }
+
+    // Cleaned foreground, zero inside exclude zones.
+    const cv::Mat& foregroundMask();
+    // One entry per 8-connected foreground component; those that can reach
+    // kMinBlobArea carry their outline area.
+    const std::vector<Blob>& foregroundBlobs();
+    // Rectangles covering every kTileSize tile of the plane that holds
+    // foreground, grown by one tile; overlapping rectangles are merged.
+    // Empty when nothing moved.
+    const std::vector<cv::Rect>& dirtyRegions();
+    const cv::Mat& gray();
+    const cv::Mat& hsv();
+
+private:
+    struct Plane {
+        std::mutex mutex;
+        bool ready = false;
+    };
+
+    template <typename Compute>
+    static void ensure(Plane& plane, Compute compute)
+    {
+        std::lock_guard<std::mutex> lock(plane.mutex);
+        if (!plane.ready) {
+            compute();
+            plane.ready = true;
+        }
+    }
+
+    cv::Mat m_frame;
+    double m_areaScale = 1.0;
+    cv::Mat m_morphKernel;
+    double m_morphologyScale = 1.0;
+    ForegroundModel m_foregroundModel;
+    ZoneMap m_zones;
+
+    Plane m_foregroundPlane;
+    Plane m_blobsPlane;
+    Plane m_regionsPlane;
+    Plane m_grayPlane;
+    Plane m_hsvPlane;
+
+    cv::Mat m_foregroundMask;
+    BlobExtractor m_foregroundBlobs;
+    cv::Mat m_dirtyTiles;
+    // The 3x3 square dilate uses for an empty kernel.
+    cv::Mat m_tileKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    BlobExtractor m_tileBlobs;
+    std::vector<cv::Rect> m_dirtyRegions;
+    cv::Mat m_gray;
+    cv::Mat m_hsv;
+};
+
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "background_model.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+class SubtractorModel : public BackgroundModel {
+public:
+    SubtractorModel(bool useMog2, bool useKnn)
+    {
+        if (useMog2) {
+            m_mog2 = cv::createBackgroundSubtractorMOG2(500, 16, true);
+        }
+        if (useKnn) {
+            m_knn = cv::createBackgroundSubtractorKNN(500, 400, true);
+        }
+    }
+
+    void apply(const cv::Mat& frame, cv::Mat& mask) override
+    {
+        if (m_mog2 && m_knn) {
+            m_mog2->apply(frame, m_foregroundMOG2);
+            m_knn->apply(frame, m_foregroundKNN);
+            cv::bitwise_and(m_foregroundMOG2, m_foregroundKNN, mask);
+        } else if (m_mog2) {
+            m_mog2->apply(frame, mask);
+        } else {
+            m_knn->apply(frame, mask);
+        }
+    }
+
+private:
+    cv::Ptr<cv::BackgroundSubtractor> m_mog2;
+    cv::Ptr<cv::BackgroundSubtractor> m_knn;
+    cv::Mat m_foregroundMOG2;
+    cv::Mat m_foregroundKNN;
+};
+
+// The background is kept as grey << 7 in int16, so the difference to a new
+// pixel and the learning step stay in 16-bit lanes. Background pixels move
+// 1/32 of the way towards the frame; foreground pixels 1/256, so an object
+// that stops is absorbed after a few hundred frames instead of lingering.
+class RunningAverageModel : public BackgroundModel {
+public:
+    void apply(const cv::Mat& frame, cv::Mat& mask) override
+    {
+        if (frame.channels() == 3) {
+            cv::cvtColor(frame, m_gray, cv::COLOR_BGR2GRAY);
+        } else {
+            m_gray = frame;
+        }
+        CV_Assert(m_gray.type() == CV_8UC1);
+
+        mask.create(m_gray.size(), CV_8UC1);
+
+        if (m_background.size() != m_gray.size()) {
+            m_gray.convertTo(m_background, CV_16S, 1 << kFractionBits);
+            mask.setTo(cv::Scalar::all(0));
+            return;
+        }
+
+        const double stripes = std::max(1.0, static_cast<double>(m_gray.total()) / kPixelsPerStripe);
+        cv::parallel_for_(cv::Range(0, m_gray.rows), [this, &mask](const cv::Range& rows) {
+            applyRows(mask, rows);
+        }, stripes);
+    }
+
+private:
+    static constexpr int kFractionBits = 7;
+    // Grey levels a pixel must differ from the background by.
+    static constexpr int kThreshold = 25 << kFractionBits;
+    static constexpr int kBackgroundShift = 5;
+    static constexpr int kForegroundShift = 8;
+    static constexpr int kPixelsPerStripe = 64 * 1024;
+
+    void applyRows(cv::Mat& mask, const cv::Range& rows)
+    {
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uchar* gray = m_gray.ptr<uchar>(y);
+            short* background = m_background.ptr<short>(y);
+            uchar* dst = mask.ptr<uchar>(y);
+            int x = 0;
+
+#if CV_SIMD128
+            const cv::v_uint16x8 threshold = cv::v_setall_u16(static_cast<ushort>(kThreshold));
+            for (; x <= m_gray.cols - 16; x += 16) {
+                cv::v_uint16x8 pixels[2];
+                cv::v_expand(cv::v_load(gray + x), pixels[0], pixels[1]);
+
+                cv::v_uint16x8 foreground[2];
+                for (int half = 0; half < 2; ++half) {
+                    short* bg = background + x + half * 8;
+                    const cv::v_int16x8 model = cv::v_load(bg);
+                    const cv::v_int16x8 diff = cv::v_reinterpret_as_s16(pixels[half] << kFractionBits) - model;
+                    foreground[half] = cv::v_abs(diff) > threshold;
+                    const cv::v_int16x8 step = cv::v_select(cv::v_reinterpret_as_s16(foreground[half]),
+                                                            diff >> kForegroundShift, diff >> kBackgroundShift);
+                    cv::v_store(bg, model + step);
+                }
+                cv::v_store(dst + x, cv::v_pack(foreground[0], foreground[1]));
+            }
+#endif
+
+            for (; x < m_gray.cols; ++x) {
+                const int diff = (gray[x] << kFractionBits) - background[x];
+                const bool foreground = std::abs(diff) > kThreshold;
+                background[x] = static_cast<short>(background[x]
+                                                   + (diff >> (foreground ? kForegroundShift : kBackgroundShift)));
+                dst[x] = foreground ? 255 : 0;
+            }
+        }
+    }
+
+    cv::Mat m_gray;
+    cv::Mat m_background;
+};
+
+}
+
+std::unique_ptr<BackgroundModel> BackgroundModel::create(Engine engine)
+{
+    switch (engine) {
+    case MOG2_KNN:
+        return std::make_unique<SubtractorModel>(true, true);
+    case MOG2:
+        return std::make_unique<SubtractorModel>(true, false);
+    case KNN:
+        return std::make_unique<SubtractorModel>(false, true);
+    case RUNNING_AVERAGE:
+        return std::make_unique<RunningAverageModel>();
+    }
+    return std::make_unique<SubtractorModel>(true, true);
+}
+
+const char* BackgroundModel::engineName(Engine engine)
+{
+    switch (engine) {
+    case MOG2_KNN:
+        return "mog2+knn";
+    case MOG2:
+        return "mog2";
+    case KNN:
+        return "knn";
+    case RUNNING_AVERAGE:
+        return "running-average";
+    }
+    return "unknown";
+}
+
+bool BackgroundModel::parseEngine(const std::string& name, Engine& engine)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    for (Engine candidate : {MOG2_KNN, MOG2, KNN, RUNNING_AVERAGE}) {
+        if (lower == engineName(candidate)) {
+            engine = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
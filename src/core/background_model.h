@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Background subtraction behind VideoProcessor's foreground mask. Engines
+// trade robustness for speed; pick per camera.
+class BackgroundModel {
+public:
+    enum Engine {
+        // MOG2 and KNN, ANDed: fewest false positives, slowest.
+        MOG2_KNN,
+        MOG2,
+        KNN,
+        // Built-in per-pixel running average of the grey image with selective
+        // update. Several times faster; suited to static, evenly lit scenes.
+        RUNNING_AVERAGE
+    };
+
+    virtual ~BackgroundModel() = default;
+
+    // Writes the binary foreground of frame into mask (CV_8UC1, nonzero for
+    // foreground) and learns from frame.
+    virtual void apply(const cv::Mat& frame, cv::Mat& mask) = 0;
+
+    static std::unique_ptr<BackgroundModel> create(Engine engine);
+
+    // "mog2+knn", "mog2", "knn", "running-average".
+    static const char* engineName(Engine engine);
+    // Accepts the names above, case-insensitively. Returns false otherwise.
+    static bool parseEngine(const std::string& name, Engine& engine);
+};
+
+}
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+#include "batch_analyzer.h"
+#include "thread_pool.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+std::string jsonEscape(const std::string& text)
+{
+    std::ostringstream out;
+    for (const char c : text) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+    }
+    return out.str();
+}
+
+}
+
+BatchAnalyzer::BatchAnalyzer()
+    : m_options()
+{
+}
+
+BatchAnalyzer::BatchAnalyzer(const Options& options)
+    : m_options(options)
+{
+}
+
+bool BatchAnalyzer::analyzeFile(const std::string& path, Report& report, ProgressCallback progress)
+{
+    const auto started = std::chrono::steady_clock::now();
+
+    report = Report();
+    report.source = path;
+
+    std::int64_t frameCount = 0;
+    try {
+        cv::VideoCapture probe(path);
+        if (!probe.isOpened()) {
+            std::cerr << "Failed to open video file: " << path << std::endl;
+            return false;
+        }
+
+        report.fps = probe.get(cv::CAP_PROP_FPS);
+        frameCount = static_cast<std::int64_t>(probe.get(cv::CAP_PROP_FRAME_COUNT));
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error while opening " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    if (!(report.fps > 0.0) || !std::isfinite(report.fps)) {
+        report.fps = 30.0;
+    }
+
+    const std::int64_t gapFrames = std::max<std::int64_t>(1, std::llround(m_options.eventGapSeconds * report.fps));
+    const std::int64_t segmentFrames = std::max<std::int64_t>(1, std::llround(m_options.segmentSeconds * report.fps));
+    const std::int64_t warmUpFrames = std::max<std::int64_t>(0, std::llround(m_options.warmUpSeconds * report.fps));
+
+    // Containers that do not report a frame count cannot be split reliably, so
+    // they are decoded front to back as a single segment.
+    std::vector<Segment> segments;
+    if (frameCount <= 0) {
+        Segment segment;
+        segment.endFrame = std::numeric_limits<std::int64_t>::max();
+        segments.push_back(segment);
+    } else {
+        for (std::int64_t first = 0; first < frameCount; first += segmentFrames) {
+            Segment segment;
+            segment.firstFrame = first;
+            segment.warmUpFrame = std::max<std::int64_t>(0, first - warmUpFrames);
+            segment.endFrame = std::min(frameCount, first + segmentFrames);
+            segments.push_back(segment);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t completed = 0;
+
+    {
+        ThreadPool pool(m_options.threadCount);
+        for (auto& segment : segments) {
+            pool.submit([this, &path, &segment, gapFrames, &mutex, &done, &completed]() {
+                analyzeSegment(path, segment, gapFrames);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ++completed;
+                }
+                done.notify_one();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        std::size_t reported = 0;
+        while (reported < segments.size()) {
+            done.wait(lock, [&]() { return completed > reported; });
+            reported = completed;
+            if (progress) {
+                lock.unlock();
+                progress(reported, segments.size());
+                lock.lock();
+            }
+        }
+    }
+
+    for (const auto& segment : segments) {
+        report.frameCount += segment.framesRead;
+        report.events.insert(report.events.end(), segment.events.begin(), segment.events.end());
+    }
+    coalesceEvents(report.events, gapFrames);
+
+    report.segmentCount = segments.size();
+    report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+void BatchAnalyzer::analyzeSegment(const std::string& path, Segment& segment, std::int64_t gapFrames) const
+{
+    try {
+        cv::VideoCapture capture(path);
+        if (!capture.isOpened()) {
+            std::cerr << "Failed to open video file for segment at frame " << segment.firstFrame << std::endl;
+            return;
+        }
+
+        if (segment.warmUpFrame > 0) {
+            capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(segment.warmUpFrame));
+        }
+
+        VideoProcessor processor;
+        processor.setIntrusionDetection(m_options.intrusionDetection);
+        processor.setFireDetection(m_options.fireDetection);
+        processor.setMotionDetection(m_options.motionDetection);
+        processor.setEquipmentFailureDetection(m_options.equipmentFailureDetection);
+        processor.setAnalysisScale(m_options.analysisScale);
+        processor.setBackgroundEngine(m_options.backgroundEngine);
+        processor.setMorphologyScale(m_options.morphologyScale);
+        processor.setDetectionStride(m_options.detectionStride);
+        processor.setZones(m_options.zones);
+        processor.setDetectorSchedule("fire", m_options.fireSchedule);
+
+        // At most one open event per detection type.
+        std::array<Event, VideoProcessor::DetectionResult::kTypeCount> open;
+
+        cv::Mat frame;
+        std::vector<VideoProcessor::DetectionResult> results;
+        for (std::int64_t index = segment.warmUpFrame; index < segment.endFrame; ++index) {
+            if (!capture.read(frame) || frame.empty()) {
+                break;
+            }
+
+            processor.processFrame(frame, results);
+            if (index < segment.firstFrame) {
+                continue;
+            }
+            ++segment.framesRead;
+
+            for (const auto& result : results) {
+                Event& event = open.at(static_cast<std::size_t>(result.type));
+                if (event.frames > 0 && index - event.lastFrame > gapFrames) {
+                    segment.events.push_back(event);
+                    event = Event();
+                }
+
+                if (event.frames == 0) {
+                    event.type = result.type;
+                    event.description = result.description;
+                    event.firstFrame = index;
+                }
+                if (event.frames == 0 || event.lastFrame != index) {
+                    ++event.frames;
+                    event.lastFrame = index;
+                }
+                if (result.confidence > event.peakConfidence) {
+                    event.peakConfidence = result.confidence;
+                    event.peakBoundingBox = result.boundingBox;
+                }
+            }
+        }
+
+        for (const auto& event : open) {
+            if (event.frames > 0) {
+                segment.events.push_back(event);
+            }
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error in segment at frame " << segment.firstFrame << ": " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in segment at frame " << segment.firstFrame << ": " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error in segment at frame " << segment.firstFrame << std::endl;
+    }
+}
+
+void BatchAnalyzer::coalesceEvents(std::vector<Event>& events, std::int64_t gapFrames)
+{
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.type != b.type) {
+            return a.type < b.type;
+        }
+        return a.firstFrame < b.firstFrame;
+    });
+
+    std::vector<Event> merged;
+    merged.reserve(events.size());
+    for (const auto& event : events) {
+        if (!merged.empty() && merged.back().type == event.type
+            && event.firstFrame - merged.back().lastFrame <= gapFrames) {
+            Event& last = merged.back();
+            last.lastFrame = std::max(last.lastFrame, event.lastFrame);
+            last.frames += event.frames;
+            if (event.peakConfidence > last.peakConfidence) {
+                last.peakConfidence = event.peakConfidence;
+                last.peakBoundingBox = event.peakBoundingBox;
+            }
+        } else {
+            merged.push_back(event);
+        }
+    }
+
+    std::stable_sort(merged.begin(), merged.end(), [](const Event& a, const Event& b) {
+        return a.firstFrame < b.firstFrame;
+    });
+    events.swap(merged);
+}
+
+void BatchAnalyzer::writeReport(const Report& report, std::ostream& out)
+{
+    const double fps = report.fps > 0.0 ? report.fps : 30.0;
+
+    out << "{\n"
+        << "  \"source\": \"" << jsonEscape(report.source) << "\",\n"
+        << "  \"fps\": " << report.fps << ",\n"
+        << "  \"frames\": " << report.frameCount << ",\n"
+        << "  \"segments\": " << report.segmentCount << ",\n"
+        << "  \"wall_seconds\": " << report.wallSeconds << ",\n"
+        << "  \"events\": [";
+
+    for (std::size_t i = 0; i < report.events.size(); ++i) {
+        const Event& event = report.events[i];
+        const cv::Rect& box = event.peakBoundingBox;
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"type\": \"" << VideoProcessor::typeName(event.type) << "\""
+            << ", \"description\": \"" << jsonEscape(event.description) << "\""
+            << ", \"start_seconds\": " << event.firstFrame / fps
+            << ", \"end_seconds\": " << event.lastFrame / fps
+            << ", \"first_frame\": " << event.firstFrame
+            << ", \"last_frame\": " << event.lastFrame
+            << ", \"frames\": " << event.frames
+            << ", \"peak_confidence\": " << event.peakConfidence
+            << ", \"peak_box\": [" << box.x << ", " << box.y << ", " << box.width << ", " << box.height << "]}";
+    }
+
+    out << (report.events.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+}
\ No newline at end of file
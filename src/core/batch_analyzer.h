@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "video_processor.h"
+
+namespace ArcticOwl::Core {
+
+// Offline analysis of recorded video files with no capture pacing. A file is
+// split into fixed-length segments that are decoded and analysed in parallel
+// on a ThreadPool. Each segment starts decoding a little earlier (the warm-up)
+// so its background subtractors have settled by the segment's first frame;
+// detections from the warm-up frames are discarded. Per-segment timelines are
+// coalesced into events and merged across segment boundaries.
+class BatchAnalyzer {
+public:
+    struct Options {
+        double segmentSeconds = 300.0;
+        double warmUpSeconds = 10.0;
+        // Frames of the same type further apart than this start a new event.
+        double eventGapSeconds = 1.0;
+        std::size_t threadCount = 0;
+        bool intrusionDetection = true;
+        bool fireDetection = true;
+        bool motionDetection = true;
+        bool equipmentFailureDetection = true;
+        double analysisScale = 1.0;
+        double morphologyScale = 1.0;
+        int detectionStride = 1;
+        Detector::Schedule fireSchedule;
+        BackgroundModel::Engine backgroundEngine = BackgroundModel::MOG2_KNN;
+        std::vector<Zone> zones;
+    };
+
+    struct Event {
+        VideoProcessor::DetectionResult::Type type = VideoProcessor::DetectionResult::MOTION;
+        std::string description;
+        std::int64_t firstFrame = 0;
+        std::int64_t lastFrame = 0;
+        std::int64_t frames = 0;
+        float peakConfidence = 0.0f;
+        cv::Rect peakBoundingBox;
+    };
+
+    struct Report {
+        std::string source;
+        double fps = 0.0;
+        std::int64_t frameCount = 0;
+        std::size_t segmentCount = 0;
+        double wallSeconds = 0.0;
+        std::vector<Event> events;
+    };
+
+    using ProgressCallback = std::function<void(std::size_t completedSegments, std::size_t totalSegments)>;
+
+    BatchAnalyzer();
+    explicit BatchAnalyzer(const Options& options);
+
+    // Returns false when the file cannot be opened; segments that fail midway
+    // are reported on std::cerr and contribute the frames they managed to read.
+    bool analyzeFile(const std::string& path, Report& report, ProgressCallback progress = ProgressCallback());
+
+    static void writeReport(const Report& report, std::ostream& out);
+
+private:
+    struct Segment {
+        std::int64_t warmUpFrame = 0;
+        std::int64_t firstFrame = 0;
+        std::int64_t endFrame = 0;
+        std::int64_t framesRead = 0;
+        std::vector<Event> events;
+    };
+
+    void analyzeSegment(const std::string& path, Segment& segment, std::int64_t gapFrames) const;
+    // Joins events of the same type that are at most gapFrames apart, which
+    // stitches together events split at segment boundaries.
+    static void coalesceEvents(std::vector<Event>& events, std::int64_t gapFrames);
+
+    Options m_options;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+
+#include "blob_extractor.h"
+
+namespace ArcticOwl::Core {
+
+BlobExtractor::BlobExtractor()
+{
+    // Their sizes follow the mask and the scene, so they would otherwise be
+    // reallocated on most frames.
+    m_reducedAllocator.attach(m_reduced);
+    m_labelsAllocator.attach(m_labels);
+    m_statsAllocator.attach(m_stats);
+    m_centroidsAllocator.attach(m_centroids);
+    m_blobMaskAllocator.attach(m_blobMask);
+}
+
+void BlobExtractor::clean(cv::Mat& mask, const cv::Mat& kernel, double scale)
+{
+    if (mask.empty()) {
+        return;
+    }
+
+    const cv::Size reducedSize(std::max(1, static_cast<int>(std::lround(mask.cols * scale))),
+                               std::max(1, static_cast<int>(std::lround(mask.rows * scale))));
+    if (scale >= 1.0 || reducedSize == mask.size()) {
+        cv::morphologyEx(mask, mask, cv::MORPH_OPEN, kernel);
+        cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, kernel);
+        return;
+    }
+
+    if (m_reducedKernelSource != kernel.size() || m_reducedKernelScale != scale) {
+        const int size = std::max(3, static_cast<int>(std::lround(kernel.cols * scale)) | 1);
+        m_reducedKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(size, size));
+        m_reducedKernelSource = kernel.size();
+        m_reducedKernelScale = scale;
+    }
+
+    // Any foreground in a reduced cell keeps the cell; the opening then
+    // removes what was only noise.
+    cv::resize(mask, m_reduced, reducedSize, 0, 0, cv::INTER_AREA);
+    cv::threshold(m_reduced, m_reduced, 0, 255, cv::THRESH_BINARY);
+    cv::morphologyEx(m_reduced, m_reduced, cv::MORPH_OPEN, m_reducedKernel);
+    cv::morphologyEx(m_reduced, m_reduced, cv::MORPH_CLOSE, m_reducedKernel);
+    cv::resize(m_reduced, mask, mask.size(), 0, 0, cv::INTER_NEAREST);
+}
+
+const std::vector<BlobExtractor::Blob>& BlobExtractor::extract(const cv::Mat& mask, double minArea)
+{
+    m_blobs.clear();
+    if (mask.empty()) {
+        return m_blobs;
+    }
+
+    const int count = cv::connectedComponentsWithStats(mask, m_labels, m_stats, m_centroids, 8, CV_32S);
+
+    // Label 0 is the background.
+    const std::size_t blobCount = static_cast<std::size_t>(std::max(0, count - 1));
+    m_blobs.reserve(blobCount);
+    if (m_outlines.size() < blobCount) {
+        m_outlines.resize(blobCount);
+    }
+    for (int label = 1; label < count; ++label) {
+        const int* stats = m_stats.ptr<int>(label);
+        const double* centroid = m_centroids.ptr<double>(label);
+
+        Blob blob;
+        blob.boundingBox = cv::Rect(stats[cv::CC_STAT_LEFT], stats[cv::CC_STAT_TOP],
+                                    stats[cv::CC_STAT_WIDTH], stats[cv::CC_STAT_HEIGHT]);
+        blob.pixels = stats[cv::CC_STAT_AREA];
+        blob.centroid = cv::Point2d(centroid[0], centroid[1]);
+        blob.label = label;
+
+        // The outline runs through boundary pixel centres, so it encloses
+        // at most (width - 1) x (height - 1); smaller boxes cannot reach
+        // minArea and are not traced.
+        std::vector<cv::Point>& outline = m_outlines[m_blobs.size()];
+        outline.clear();
+        const double maxArea = static_cast<double>(blob.boundingBox.width - 1) * (blob.boundingBox.height - 1);
+        if (maxArea >= minArea) {
+            traceOutline(blob, outline);
+            blob.area = outline.empty() ? 0.0 : cv::contourArea(outline);
+        }
+        m_blobs.push_back(blob);
+    }
+
+    return m_blobs;
+}
+
+const std::vector<cv::Point>& BlobExtractor::outline(const Blob& blob) const
+{
+    static const std::vector<cv::Point> empty;
+    const std::size_t index = static_cast<std::size_t>(blob.label - 1);
+    return (blob.label > 0 && index < m_blobs.size()) ? m_outlines[index] : empty;
+}
+
+void BlobExtractor::traceOutline(const Blob& blob, std::vector<cv::Point>& contour)
+{
+    contour.clear();
+    if (m_labels.empty() || blob.boundingBox.area() <= 0) {
+        return;
+    }
+
+    // A one-pixel zero border keeps blobs that touch the box edge closed.
+    const cv::Rect& box = blob.boundingBox;
+    m_blobMask.create(box.height + 2, box.width + 2, CV_8UC1);
+    m_blobMask.setTo(cv::Scalar::all(0));
+    cv::Mat inner = m_blobMask(cv::Rect(1, 1, box.width, box.height));
+    cv::compare(m_labels(box), blob.label, inner, cv::CMP_EQ);
+
+    cv::findContours(m_blobMask, m_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE,
+                     box.tl() - cv::Point(1, 1));
+
+    // One component has one outer contour. Copied rather than swapped, so
+    // both vectors keep their own capacity.
+    if (!m_contours.empty()) {
+        contour.assign(m_contours.front().begin(), m_contours.front().end());
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "scratch_allocator.h"
+
+namespace ArcticOwl::Core {
+
+// Turns a binary mask into blobs: morphological cleanup, then one
+// connectedComponentsWithStats pass that yields every blob's pixel count,
+// box and centroid. Outlines are traced per blob and only inside its box,
+// and only for blobs large enough to matter, so a busy mask full of specks
+// does not pay for tracing them.
+// Not thread-safe; keep one per mask producer. Buffers are reused, also
+// when the mask size or the blob count changes from one call to the next.
+class BlobExtractor {
+public:
+    BlobExtractor();
+
+    struct Blob {
+        cv::Rect boundingBox;
+        int pixels = 0;
+        // Area enclosed by the outer contour (cv::contourArea), which the
+        // detectors' thresholds are tuned on. It is about half the perimeter
+        // below the pixel count, so near 0 for a one-pixel-wide blob. Only
+        // measured for blobs traced by extract(); 0 for the rest.
+        double area = 0.0;
+        cv::Point2d centroid;
+        // Component label in the last extract().
+        int label = 0;
+    };
+
+    // Opens then closes mask in place with kernel. With scale < 1 the two
+    // passes run on a copy reduced by scale, with a kernel reduced to match,
+    // and the result is scaled back up.
+    void clean(cv::Mat& mask, const cv::Mat& kernel, double scale = 1.0);
+
+    // Labels the nonzero pixels of mask (8-connected, like findContours).
+    // Blobs whose bounding box could enclose minArea get their outline
+    // traced, for area and outline(); the rest are only counted and boxed.
+    const std::vector<Blob>& extract(const cv::Mat& mask,
+                                     double minArea = std::numeric_limits<double>::infinity());
+    const std::vector<Blob>& blobs() const { return m_blobs; }
+
+    // Outer contour of a blob from the last extract(), in mask coordinates.
+    // Empty if the blob was not traced.
+    const std::vector<cv::Point>& outline(const Blob& blob) const;
+
+private:
+    // Declared first so they outlive the Mats they back.
+    ScratchAllocator m_reducedAllocator;
+    ScratchAllocator m_labelsAllocator;
+    ScratchAllocator m_statsAllocator;
+    ScratchAllocator m_centroidsAllocator;
+    ScratchAllocator m_blobMaskAllocator;
+
+    cv::Mat m_reduced;
+    cv::Mat m_reducedKernel;
+    cv::Size m_reducedKernelSource;
+    double m_reducedKernelScale = 0.0;
+
+    cv::Mat m_labels;
+    cv::Mat m_stats;
+    cv::Mat m_centroids;
+    std::vector<Blob> m_blobs;
+
+    void traceOutline(const Blob& blob, std::vector<cv::Point>& outline);
+
+    cv::Mat m_blobMask;
+    // Not cleared between calls: findContours resizes it, so the inner
+    // vectors keep their capacity.
+    std::vector<std::vector<cv::Point>> m_contours;
+    // One per blob, by index; only the traced ones are filled.
+    std::vector<std::vector<cv::Point>> m_outlines;
+};
+
+}
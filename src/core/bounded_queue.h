@@ -0,0 +1,120 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ArcticOwl::Core {
+
+// Fixed-capacity ring buffer shared between one producer and one consumer
+// thread. When full, push() overwrites the oldest entry so the consumer
+// always sees the most recent frames ("latest frame wins").
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : m_slots(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    // Returns false when an older entry had to be discarded to make room.
+    bool push(T item)
+    {
+        bool kept = true;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed) {
+                return false;
+            }
+
+            if (m_count == m_slots.size()) {
+                m_slots[m_head] = std::move(item);
+                m_head = (m_head + 1) % m_slots.size();
+                kept = false;
+            } else {
+                m_slots[(m_head + m_count) % m_slots.size()] = std::move(item);
+                ++m_count;
+            }
+        }
+        m_cv.notify_one();
+        return kept;
+    }
+
+    // Blocks until an entry is available; returns false once closed and drained.
+    bool waitPop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_count > 0 || m_closed; });
+        return popLocked(item);
+    }
+
+    bool tryPop(T& item)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return popLocked(item);
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_cv.notify_all();
+    }
+
+    void reopen()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clearLocked();
+        m_closed = false;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clearLocked();
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    std::size_t capacity() const { return m_slots.size(); }
+
+private:
+    bool popLocked(T& item)
+    {
+        if (m_count == 0) {
+            return false;
+        }
+
+        item = std::move(m_slots[m_head]);
+        m_slots[m_head] = T();
+        m_head = (m_head + 1) % m_slots.size();
+        --m_count;
+        return true;
+    }
+
+    void clearLocked()
+    {
+        for (auto& slot : m_slots) {
+            slot = T();
+        }
+        m_head = 0;
+        m_count = 0;
+    }
+
+    std::vector<T> m_slots;
+    std::size_t m_head = 0;
+    std::size_t m_count = 0;
+    bool m_closed = false;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+}
\ No newline at end of file
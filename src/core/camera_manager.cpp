@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "camera_manager.h"
+#include "metrics.h"
+
+namespace ArcticOwl::Core {
+
+CameraManager::CameraManager(QObject* parent, std::size_t threadCount)
+    : QObject(parent)
+    , m_pool(threadCount)
+{
+}
+
+CameraManager::~CameraManager()
+{
+    stopCameraSystem();
+}
+
+int CameraManager::addCamera(const CameraSource& source)
+{
+    if (m_running) {
+        std::cerr << "Cannot add a camera while the system is running." << std::endl;
+        return -1;
+    }
+
+    auto camera = std::make_unique<Camera>();
+    camera->source = source;
+    if (camera->source.location.empty()) {
+        camera->source.location = describeSource(source);
+    }
+
+    m_cameras.push_back(std::move(camera));
+    return static_cast<int>(m_cameras.size()) - 1;
+}
+
+void CameraManager::clearCameras()
+{
+    if (m_running) {
+        std::cerr << "Cannot remove cameras while the system is running." << std::endl;
+        return;
+    }
+
+    m_cameras.clear();
+}
+
+bool CameraManager::startCameraSystem()
+{
+    if (m_running) {
+        return true;
+    }
+
+    int started = 0;
+    for (std::size_t i = 0; i < m_cameras.size(); ++i) {
+        if (startCamera(static_cast<int>(i), *m_cameras[i])) {
+            ++started;
+        }
+    }
+
+    m_running = started > 0;
+    if (!m_running) {
+        stopCameraSystem();
+    }
+
+    return m_running;
+}
+
+bool CameraManager::stopCameraSystem()
+{
+    try {
+        for (auto& camera : m_cameras) {
+            stopCamera(*camera);
+        }
+
+        m_running = false;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to stop cameras: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error while stopping cameras." << std::endl;
+    }
+
+    return false;
+}
+
+bool CameraManager::startCamera(int index, Camera& camera)
+{
+    try {
+        const double analysisScale = camera.source.analysisScale > 0.0 ? camera.source.analysisScale
+                                                                        : m_analysisScale;
+        camera.processor = std::make_unique<VideoProcessor>();
+        camera.processor->setIntrusionDetection(m_intrusionDetection);
+        camera.processor->setFireDetection(m_fireDetection);
+        camera.processor->setMotionDetection(m_motionDetection);
+        camera.processor->setEquipmentFailureDetection(m_equipmentFailureDetection);
+        camera.processor->setAnalysisScale(analysisScale);
+        camera.processor->setThreadPool(&m_pool);
+        camera.processor->setBackgroundEngine(camera.source.backgroundEngine);
+        camera.processor->setMorphologyScale(m_morphologyScale);
+        camera.processor->setDetectionStride(m_detectionStride);
+        camera.processor->setZones(camera.source.zones);
+        if (m_objectQueue) {
+            camera.processor->addDetector(std::make_unique<DnnDetector>(m_objectQueue, m_objectInterval));
+        }
+        for (const auto& entry : m_detectorSchedules) {
+            camera.processor->setDetectorSchedule(entry.first, entry.second);
+        }
+
+        camera.worker = std::make_unique<ProcessingWorker>(camera.processor.get(), nullptr, 1, &m_pool);
+        camera.worker->setPreviewEnabled(index == m_previewCamera.load());
+        camera.worker->setMetricsLabels(MetricsRegistry::cameraLabel(index));
+
+        if (m_frameSink) {
+            camera.worker->setFrameSink(m_frameSink);
+        }
+
+        connect(camera.worker.get(), &ProcessingWorker::frameProcessed,
+                this, &CameraManager::frameProcessed);
+
+        camera.capture = std::make_unique<VideoCapture>(nullptr, camera.source.cameraId,
+                                                        camera.source.rtspUrl, camera.source.rtmpUrl);
+        camera.capture->setMetricsLabels(MetricsRegistry::cameraLabel(index));
+        camera.capture->setCameraIndex(index);
+        camera.capture->setTargetFps(camera.source.targetFps);
+        V4l2Capture::Options v4l2 = camera.source.v4l2;
+        if (m_compressedSink) {
+            // Decoded frames no longer feed the stream, so only analysis needs them.
+            v4l2.decodeReduction = decodeReductionFor(analysisScale);
+            camera.capture->setCompressedSink(m_compressedSink);
+        }
+        camera.capture->setV4l2Options(v4l2);
+        ProcessingWorker* worker = camera.worker.get();
+        camera.capture->setReadyProbe([worker]() { return worker->acceptsFrames(); });
+        connect(camera.capture.get(), &VideoCapture::frameReady,
+                camera.worker.get(), &ProcessingWorker::submitFrame, Qt::DirectConnection);
+
+        // A reconnect may land on a different backend or format, so the
+        // decoded size relative to the source is refreshed every time.
+        VideoProcessor* processor = camera.processor.get();
+        VideoCapture* capture = camera.capture.get();
+        connect(capture, &VideoCapture::connectionChanged, this, [processor, capture](bool connected) {
+            if (connected) {
+                processor->setInputScale(capture->decodeScale());
+            }
+        }, Qt::DirectConnection);
+
+        if (!camera.worker->startProcessingSystem() || !camera.capture->startVideoCaptureSystem()) {
+            stopCamera(camera);
+            camera.state = CameraStatus::FAILED;
+            return false;
+        }
+
+        camera.state = CameraStatus::RUNNING;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to start camera " << camera.source.location << ": " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error while starting camera " << camera.source.location << std::endl;
+    }
+
+    stopCamera(camera);
+    camera.state = CameraStatus::FAILED;
+    return false;
+}
+
+void CameraManager::stopCamera(Camera& camera)
+{
+    if (camera.capture) {
+        camera.capture->stopVideoCaptureSystem();
+    }
+    if (camera.worker) {
+        camera.worker->stopProcessingSystem();
+    }
+
+    camera.capture.reset();
+    camera.worker.reset();
+    camera.processor.reset();
+
+    if (camera.state == CameraStatus::RUNNING) {
+        camera.state = CameraStatus::STOPPED;
+    }
+}
+
+std::vector<CameraManager::CameraStatus> CameraManager::cameraStatuses() const
+{
+    std::vector<CameraStatus> statuses;
+    statuses.reserve(m_cameras.size());
+
+    for (std::size_t i = 0; i < m_cameras.size(); ++i) {
+        const Camera& camera = *m_cameras[i];
+
+        CameraStatus status;
+        status.index = static_cast<int>(i);
+        status.location = camera.source.location;
+        status.state = camera.state;
+        if (camera.worker) {
+            status.fps = camera.worker->processingFps();
+            status.processedFrames = camera.worker->processedFrames();
+            status.droppedFrames = camera.worker->droppedFrames();
+        }
+        if (camera.capture) {
+            status.sourceFps = camera.capture->sourceFps();
+            status.droppedFrames += camera.capture->droppedFrames();
+            status.reconnects = camera.capture->reconnectCount();
+            if (camera.state == CameraStatus::RUNNING && !camera.capture->isConnected()) {
+                status.state = CameraStatus::RECONNECTING;
+            }
+        }
+        statuses.push_back(status);
+    }
+
+    return statuses;
+}
+
+void CameraManager::setIntrusionDetection(bool enabled)
+{
+    m_intrusionDetection = enabled;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setIntrusionDetection(enabled);
+        }
+    }
+}
+
+void CameraManager::setFireDetection(bool enabled)
+{
+    m_fireDetection = enabled;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setFireDetection(enabled);
+        }
+    }
+}
+
+void CameraManager::setMotionDetection(bool enabled)
+{
+    m_motionDetection = enabled;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setMotionDetection(enabled);
+        }
+    }
+}
+
+void CameraManager::setEquipmentFailureDetection(bool enabled)
+{
+    m_equipmentFailureDetection = enabled;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setEquipmentFailureDetection(enabled);
+        }
+    }
+}
+
+void CameraManager::setAnalysisScale(double scale)
+{
+    m_analysisScale = scale;
+    for (auto& camera : m_cameras) {
+        if (camera->processor && camera->source.analysisScale <= 0.0) {
+            camera->processor->setAnalysisScale(scale);
+        }
+    }
+}
+
+void CameraManager::setMorphologyScale(double scale)
+{
+    m_morphologyScale = scale;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setMorphologyScale(scale);
+        }
+    }
+}
+
+void CameraManager::setDetectionStride(int stride)
+{
+    m_detectionStride = stride;
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setDetectionStride(stride);
+        }
+    }
+}
+
+void CameraManager::setObjectDetection(std::shared_ptr<DnnInferenceQueue> queue, int interval)
+{
+    m_objectQueue = std::move(queue);
+    m_objectInterval = std::max(1, interval);
+}
+
+void CameraManager::setDetectorSchedule(const std::string& name, const Detector::Schedule& schedule)
+{
+    auto entry = std::find_if(m_detectorSchedules.begin(), m_detectorSchedules.end(),
+                              [&name](const auto& existing) { return existing.first == name; });
+    if (entry != m_detectorSchedules.end()) {
+        entry->second = schedule;
+    } else {
+        m_detectorSchedules.emplace_back(name, schedule);
+    }
+
+    for (auto& camera : m_cameras) {
+        if (camera->processor) {
+            camera->processor->setDetectorSchedule(name, schedule);
+        }
+    }
+}
+
+void CameraManager::setPreviewCamera(int cameraIndex)
+{
+    m_previewCamera = cameraIndex;
+    for (std::size_t i = 0; i < m_cameras.size(); ++i) {
+        if (m_cameras[i]->worker) {
+            m_cameras[i]->worker->setPreviewEnabled(static_cast<int>(i) == cameraIndex);
+        }
+    }
+}
+
+void CameraManager::setFrameSink(FrameSink sink)
+{
+    m_frameSink = std::move(sink);
+}
+
+void CameraManager::setCompressedFrameSink(CompressedFrameSink sink)
+{
+    m_compressedSink = std::move(sink);
+}
+
+bool CameraManager::isPassthroughActive(int cameraIndex) const
+{
+    if (cameraIndex < 0 || cameraIndex >= static_cast<int>(m_cameras.size())) {
+        return false;
+    }
+
+    const Camera& camera = *m_cameras[static_cast<std::size_t>(cameraIndex)];
+    return camera.capture && camera.capture->isPassthroughActive();
+}
+
+int CameraManager::decodeReductionFor(double analysisScale)
+{
+    // libjpeg scales by 1/2, 1/4 or 1/8; never decode below the analysis plane.
+    int reduction = 1;
+    while (reduction < 8 && analysisScale * reduction * 2 <= 1.0) {
+        reduction *= 2;
+    }
+    return reduction;
+}
+
+std::string CameraManager::describeSource(const CameraSource& source)
+{
+    if (!source.rtspUrl.empty()) {
+        return source.rtspUrl;
+    }
+    if (!source.rtmpUrl.empty()) {
+        return source.rtmpUrl;
+    }
+    return "camera:" + std::to_string(source.cameraId);
+}
+
+}
\ No newline at end of file
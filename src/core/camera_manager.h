@@ -0,0 +1,161 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "background_model.h"
+#include "dnn_detector.h"
+#include "frame.h"
+#include "processing_worker.h"
+#include "thread_pool.h"
+#include "video_capture.h"
+#include "video_processor.h"
+
+namespace ArcticOwl::Core {
+
+class CameraManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct CameraSource {
+        int cameraId = -1;
+        std::string rtspUrl;
+        std::string rtmpUrl;
+        std::string location;
+        // Frames per second handed to detection; 0 analyses every frame.
+        double targetFps = 0.0;
+        // Detector downscale factor; 0 uses the manager-wide setting.
+        double analysisScale = 0.0;
+        // Background subtraction engine behind motion and intrusion.
+        BackgroundModel::Engine backgroundEngine = BackgroundModel::MOG2_KNN;
+        // Intrusion and exclusion zones; empty guards the central quarter.
+        std::vector<Zone> zones;
+        // Native V4L2 capture for local cameras (cameraId >= 0).
+        V4l2Capture::Options v4l2;
+    };
+
+    struct CameraStatus {
+        enum State {
+            IDLE,
+            RUNNING,
+            FAILED,
+            STOPPED,
+            // Running, but the source was lost and is being reopened.
+            RECONNECTING
+        };
+
+        int index = -1;
+        std::string location;
+        State state = IDLE;
+        double fps = 0.0;
+        double sourceFps = 0.0;
+        std::uint64_t processedFrames = 0;
+        std::uint64_t droppedFrames = 0;
+        std::uint64_t reconnects = 0;
+    };
+
+    // Frames carry their camera index in Frame::cameraIndex.
+    using FrameSink = std::function<void(const Frame& annotatedFrame,
+                                         const std::vector<VideoProcessor::DetectionResult>& results)>;
+    // Grabbed frame whose image wraps the JPEG bitstream, valid only for the
+    // duration of the call.
+    using CompressedFrameSink = std::function<void(const Frame& encoded)>;
+
+    // threadCount == 0 sizes the shared detection pool to the core count.
+    explicit CameraManager(QObject* parent = nullptr, std::size_t threadCount = 0);
+    ~CameraManager();
+
+    // Cameras can only be added while the system is stopped.
+    int addCamera(const CameraSource& source);
+    void clearCameras();
+
+    // Returns true when at least one camera started.
+    bool startCameraSystem();
+    bool stopCameraSystem();
+
+    std::size_t cameraCount() const { return m_cameras.size(); }
+    std::vector<CameraStatus> cameraStatuses() const;
+
+    void setIntrusionDetection(bool enabled);
+    void setFireDetection(bool enabled);
+    void setMotionDetection(bool enabled);
+    void setEquipmentFailureDetection(bool enabled);
+    // Default detector downscale for cameras without their own analysisScale.
+    void setAnalysisScale(double scale);
+    // Mask cleanup resolution for every camera, see VideoProcessor.
+    void setMorphologyScale(double scale);
+    // Full detection on every stride-th frame of every camera, see
+    // VideoProcessor.
+    void setDetectionStride(int stride);
+    // Applies to the named detector of every camera.
+    void setDetectorSchedule(const std::string& name, const Detector::Schedule& schedule);
+    // Adds a DnnDetector to every camera, all sharing queue, so their frames
+    // are batched into common forward passes; each camera submits every
+    // interval-th analysed frame. Null turns it off. Takes effect when the
+    // cameras next start.
+    void setObjectDetection(std::shared_ptr<DnnInferenceQueue> queue, int interval);
+
+    // Only the previewed camera emits frameProcessed towards the GUI thread.
+    void setPreviewCamera(int cameraIndex);
+    int previewCamera() const { return m_previewCamera.load(); }
+
+    // Invoked on pool threads for every processed frame of every camera. Set before start.
+    void setFrameSink(FrameSink sink);
+
+    // Invoked on capture threads with the untouched bitstream of cameras that
+    // deliver MJPEG, so they can be streamed without re-encoding. Those cameras
+    // then decode for analysis only, at the largest libjpeg reduction that
+    // still covers their analysis scale. Set before start.
+    void setCompressedFrameSink(CompressedFrameSink sink);
+
+    // True while the camera feeds the compressed sink; its annotated frames
+    // then need not be encoded for streaming. Callable from sinks.
+    bool isPassthroughActive(int cameraIndex) const;
+
+    static std::string describeSource(const CameraSource& source);
+
+signals:
+    void frameProcessed(const ArcticOwl::Core::Frame& annotatedFrame,
+                        const std::vector<ArcticOwl::Core::VideoProcessor::DetectionResult>& results);
+
+private:
+    struct Camera {
+        CameraSource source;
+        std::unique_ptr<VideoProcessor> processor;
+        std::unique_ptr<ProcessingWorker> worker;
+        std::unique_ptr<VideoCapture> capture;
+        CameraStatus::State state = CameraStatus::IDLE;
+    };
+
+    bool startCamera(int index, Camera& camera);
+    static int decodeReductionFor(double analysisScale);
+    void stopCamera(Camera& camera);
+
+    ThreadPool m_pool;
+    std::vector<std::unique_ptr<Camera>> m_cameras;
+    FrameSink m_frameSink;
+    CompressedFrameSink m_compressedSink;
+    std::atomic<int> m_previewCamera{0};
+    bool m_intrusionDetection = true;
+    bool m_fireDetection = true;
+    bool m_motionDetection = true;
+    bool m_equipmentFailureDetection = true;
+    double m_analysisScale = 1.0;
+    double m_morphologyScale = 1.0;
+    int m_detectionStride = 1;
+    std::vector<std::pair<std::string, Detector::Schedule>> m_detectorSchedules;
+    std::shared_ptr<DnnInferenceQueue> m_objectQueue;
+    int m_objectInterval = 1;
+    bool m_running = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+struct DetectionResult {
+    enum Type {
+        INTRUSION,
+        FIRE,
+        EQUIPMENT_FAILURE,
+        MOTION,
+        // Object found by a DnnDetector; description holds the class name.
+        OBJECT
+    };
+    // Number of Type values; OBJECT must stay the last one.
+    static constexpr int kTypeCount = OBJECT + 1;
+
+    Type type;
+    cv::Rect boundingBox;
+    float confidence;
+    // Static text (a literal or an interned class name), so results copy
+    // without touching the heap.
+    const char* description = "";
+    // Stable across frames for the same object (see Tracker); -1 if the
+    // result was not tracked.
+    int trackId = -1;
+    // Model class index of OBJECT results; -1 otherwise.
+    int classId = -1;
+};
+
+}
@@ -0,0 +1,66 @@
+#include "detector.h"
+#include "detectors.h"
+
+namespace ArcticOwl::Core {
+
+DetectorRegistry::DetectorRegistry()
+{
+    // Registered here rather than through static initialisers, which the
+    // linker drops from a static library when nothing else references them.
+    registerDetector("motion", []() { return std::make_unique<MotionDetector>(); });
+    registerDetector("intrusion", []() { return std::make_unique<IntrusionDetector>(); });
+    registerDetector("fire", []() { return std::make_unique<FireDetector>(); });
+    registerDetector("equipment", []() { return std::make_unique<EquipmentFailureDetector>(); });
+}
+
+DetectorRegistry& DetectorRegistry::instance()
+{
+    static DetectorRegistry registry;
+    return registry;
+}
+
+bool DetectorRegistry::registerDetector(const std::string& name, Factory factory)
+{
+    if (!factory) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_factories) {
+        if (entry.first == name) {
+            return false;
+        }
+    }
+
+    m_factories.emplace_back(name, std::move(factory));
+    return true;
+}
+
+std::unique_ptr<Detector> DetectorRegistry::create(const std::string& name) const
+{
+    Factory factory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_factories) {
+            if (entry.first == name) {
+                factory = entry.second;
+                break;
+            }
+        }
+    }
+
+    return factory ? factory() : nullptr;
+}
+
+std::vector<std::string> DetectorRegistry::names() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> names;
+    names.reserve(m_factories.size());
+    for (const auto& entry : m_factories) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "analysis_context.h"
+#include "detection_result.h"
+
+namespace ArcticOwl::Core {
+
+// One analysis stage run by VideoProcessor on every frame. Detectors read the
+// shared AnalysisContext and return boxes in analysis-plane coordinates; the
+// processor maps them back to the frame it was given.
+class Detector {
+public:
+    // Context planes a detector reads. Detectors with no plane in common are
+    // independent and may run concurrently.
+    enum Input : unsigned {
+        FOREGROUND = 1u << 0,
+        GRAY = 1u << 1,
+        HSV = 1u << 2
+    };
+    using Inputs = unsigned;
+
+    // Where and how often VideoProcessor runs a detector.
+    struct Schedule {
+        // Examine only the regions where the foreground changed (see
+        // AnalysisContext::dirtyRegions) and skip frames where nothing did.
+        bool foregroundGated = false;
+        // For gated detectors: scan the whole frame every this many frames
+        // regardless, so a static scene is still checked; 0 never does.
+        int refreshInterval = 0;
+    };
+
+    explicit Detector(std::string name) : m_name(std::move(name)) {}
+    virtual ~Detector() = default;
+
+    Detector(const Detector&) = delete;
+    Detector& operator=(const Detector&) = delete;
+
+    const std::string& name() const { return m_name; }
+    virtual Inputs inputs() const = 0;
+
+    // Called once per frame, never concurrently with itself. A gated detector
+    // is not called at all on frames where it has no region to examine.
+    // Appends to results, which arrives empty; the processor keeps one vector
+    // per detector, so its capacity carries over from frame to frame.
+    virtual void detect(AnalysisContext& context, std::vector<DetectionResult>& results) = 0;
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled.load(); }
+
+    void setSchedule(const Schedule& schedule)
+    {
+        m_refreshInterval = schedule.refreshInterval;
+        m_foregroundGated = schedule.foregroundGated;
+    }
+    Schedule schedule() const { return {m_foregroundGated.load(), m_refreshInterval.load()}; }
+
+    // Analysis-plane regions to examine in the current detect() call: the
+    // whole frame unless the detector is gated. Detectors that cannot work
+    // on part of a frame may ignore it.
+    const std::vector<cv::Rect>& regions() const { return m_regions; }
+
+private:
+    // Assigns regions before each frame.
+    friend class VideoProcessor;
+
+    std::string m_name;
+    std::atomic<bool> m_enabled{true};
+    std::atomic<bool> m_foregroundGated{false};
+    std::atomic<int> m_refreshInterval{0};
+    std::vector<cv::Rect> m_regions;
+    int m_framesUntilFullScan = 0;
+};
+
+// Named detector factories. Every VideoProcessor instantiates the registered
+// detectors in registration order, so a new detector only needs a factory
+// here. The built-in "motion", "intrusion", "fire", and "equipment" detectors
+// are always registered first.
+class DetectorRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<Detector>()>;
+
+    static DetectorRegistry& instance();
+
+    // Returns false if name is already taken.
+    bool registerDetector(const std::string& name, Factory factory);
+    std::unique_ptr<Detector> create(const std::string& name) const;
+    std::vector<std::string> names() const;
+
+private:
+    DetectorRegistry();
+
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<std::string, Factory>> m_factories;
+};
+
+}
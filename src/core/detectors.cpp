@@ -0,0 +1,247 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "detectors.h"
+#include "fire_color_mask.h"
+
+namespace ArcticOwl::Core {
+
+void MotionDetector::detect(AnalysisContext& context, std::vector<DetectionResult>& results)
+{
+    if (context.frame().empty()) {
+        return;
+    }
+
+    try {
+        for (const auto& blob : context.foregroundBlobs()) {
+            if (blob.area < context.analysisArea(AnalysisContext::kMinBlobArea)) continue;
+
+            double confidence = std::min(1.0, blob.area / context.analysisArea(10000.0));
+
+            DetectionResult result;
+            result.type = DetectionResult::MOTION;
+            result.boundingBox = blob.boundingBox;
+            result.confidence = static_cast<float>(confidence);
+            result.description = "motion";
+            results.push_back(result);
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error during motion detection: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during motion detection: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error during motion detection" << std::endl;
+    }
+}
+
+void IntrusionDetector::detect(AnalysisContext& context, std::vector<DetectionResult>& results)
+{
+    const cv::Mat& frame = context.frame();
+    if (frame.empty()) {
+        return;
+    }
+
+    try {
+        const ZoneMap& zones = context.zones();
+
+        // Same blobs and thresholds as MotionDetector, taken from the shared
+        // foreground instead of running the background models again. The
+        // include zones are one integral image, so each test is four reads
+        // however many zones there are.
+        for (const auto& blob : context.foregroundBlobs()) {
+            if (blob.area < context.analysisArea(AnalysisContext::kMinBlobArea)) continue;
+
+            if (zones.includedArea(blob.boundingBox) > 0) {
+                DetectionResult result;
+                result.type = DetectionResult::INTRUSION;
+                result.boundingBox = blob.boundingBox;
+                result.confidence = static_cast<float>(std::min(1.0, blob.area / context.analysisArea(10000.0)));
+                result.description = "intrusion";
+                results.push_back(result);
+            }
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error during intrusion detection: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during intrusion detection: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error during intrusion detection" << std::endl;
+    }
+}
+
+FireDetector::FireDetector()
+    : Detector("fire")
+{
+    m_colorMaskAllocator.attach(m_colorMask);
+}
+
+void FireDetector::detect(AnalysisContext& context, std::vector<DetectionResult>& results)
+{
+    const cv::Mat& frame = context.frame();
+    if (frame.empty()) {
+        return;
+    }
+
+    try {
+        for (const cv::Rect& region : regions()) {
+            const cv::Mat regionPixels = frame(region);
+
+            // One fused pass instead of cvtColor to HSV, two inRange calls and
+            // a bitwise_or; the mask is bit-identical.
+            fireColorMask(regionPixels, m_colorMask);
+
+            m_blobs.clean(m_colorMask, context.morphKernel(), context.morphologyScale());
+
+            // Box and pixel count come from one labelling pass; the outline,
+            // for the area and the shape feature, is traced just for blobs
+            // whose box can pass the area filter.
+            const double minArea = context.analysisArea(AnalysisContext::kMinBlobArea);
+            const std::vector<BlobExtractor::Blob>& blobs = m_blobs.extract(m_colorMask, minArea);
+
+            // Gradient energy is computed once over the area the candidates
+            // cover, so overlapping candidates share it and each texture is
+            // four integral reads.
+            cv::Rect candidateArea;
+            for (const auto& blob : blobs) {
+                if (blob.area < minArea) continue;
+                candidateArea = candidateArea.empty() ? blob.boundingBox : (candidateArea | blob.boundingBox);
+            }
+            if (candidateArea.empty()) continue;
+            m_gradients.compute(regionPixels, candidateArea);
+
+            for (const auto& blob : blobs) {
+                if (blob.area < minArea) continue;
+                const cv::Rect& boundingBox = blob.boundingBox;
+
+                double texture = std::max(0.0, std::min(1.0, m_gradients.meanMagnitude(boundingBox) / 255.0));
+
+                double shape = shapeFeature(m_blobs.outline(blob));
+
+                double colorConfidence = std::min(1.0, blob.area / context.analysisArea(5000.0));
+                double textureConfidence = texture;
+                double shapeConfidence = shape;
+                double confidence = (colorConfidence + textureConfidence + shapeConfidence) / 3.0;
+
+                if (confidence > 0.4) {
+                    DetectionResult result;
+                    result.type = DetectionResult::FIRE;
+                    result.boundingBox = boundingBox + region.tl();
+                    result.confidence = static_cast<float>(std::min(1.0, confidence));
+                    result.description = "fire";
+                    results.push_back(result);
+                }
+            }
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error during fire detection: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during fire detection: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error during fire detection" << std::endl;
+    }
+}
+
+double FireDetector::textureFeature(const cv::Mat& image)
+{
+    if (image.empty()) {
+        return 0.0;
+    }
+
+    try {
+        GradientEnergyMap gradients;
+        gradients.compute(image, cv::Rect(0, 0, image.cols, image.rows));
+        double meanGradient = gradients.meanMagnitude(cv::Rect(0, 0, image.cols, image.rows));
+
+        return std::max(0.0, std::min(1.0, meanGradient / 255.0));
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+double FireDetector::shapeFeature(const std::vector<cv::Point>& contour)
+{
+    if (contour.empty()) {
+        return 0.0;
+    }
+
+    try {
+        double area = cv::contourArea(contour);
+        double perimeter = cv::arcLength(contour, true);
+
+        if (perimeter == 0) return 0;
+
+        double circularity = (4 * CV_PI * area) / (perimeter * perimeter);
+
+        return std::max(0.0, std::min(1.0, circularity / 0.8));
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+void EquipmentFailureDetector::detect(AnalysisContext& context, std::vector<DetectionResult>& results)
+{
+    // Consecutive frames a condition must hold before it is reported; a
+    // frozen picture needs longer, as static scenes can encode to identical
+    // frames for a moment.
+    constexpr int kConfirmFrames = 15;
+    constexpr int kFrozenFrames = 100;
+    // A changed view that persists this long is taken as the new normal.
+    constexpr int kAcceptFrames = 250;
+
+    const cv::Mat& frame = context.frame();
+    if (frame.empty()) {
+        return;
+    }
+
+    try {
+        const SceneModel::Observation& observation = m_scene.observe(frame);
+        m_identicalFrames = observation.identical ? m_identicalFrames + 1 : 0;
+
+        Fault fault = NONE;
+        double confidence = 0.0;
+        if (m_identicalFrames >= kFrozenFrames) {
+            fault = FROZEN;
+            confidence = std::min(1.0, static_cast<double>(m_identicalFrames) / (2 * kFrozenFrames));
+        } else if (observation.settled && observation.occludedFraction >= 0.6) {
+            fault = OCCLUDED;
+            confidence = observation.occludedFraction;
+        } else if (observation.settled && observation.sharpnessRatio < 0.4) {
+            fault = DEFOCUSED;
+            confidence = 1.0 - observation.sharpnessRatio;
+        } else if (observation.settled && observation.layoutCorrelation < 0.5) {
+            fault = MOVED;
+            confidence = std::min(1.0, 1.0 - observation.layoutCorrelation);
+        }
+
+        m_faultFrames = (fault != NONE && fault == m_fault) ? m_faultFrames + 1 : (fault != NONE ? 1 : 0);
+        m_fault = fault;
+
+        // The baseline only learns the normal view, so a fault stays visible
+        // for as long as it lasts.
+        if (fault == NONE) {
+            m_scene.learn();
+        } else if (fault == MOVED && m_faultFrames >= kAcceptFrames) {
+            m_scene.rebaseline();
+        }
+
+        if (fault != NONE && (fault == FROZEN || m_faultFrames >= kConfirmFrames)) {
+            static const char* const descriptions[] = {"", "frozen frame", "lens covered", "out of focus",
+                                                       "camera moved"};
+            DetectionResult result;
+            result.type = DetectionResult::EQUIPMENT_FAILURE;
+            result.boundingBox = cv::Rect(0, 0, frame.cols, frame.rows);
+            result.confidence = static_cast<float>(confidence);
+            result.description = descriptions[fault];
+            results.push_back(result);
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error during equipment failure detection: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during equipment failure detection: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error during equipment failure detection" << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "blob_extractor.h"
+#include "detector.h"
+#include "gradient_energy.h"
+#include "scene_model.h"
+#include "scratch_allocator.h"
+
+namespace ArcticOwl::Core {
+
+// Foreground blobs above the minimum area.
+class MotionDetector : public Detector {
+public:
+    MotionDetector() : Detector("motion") {}
+
+    Inputs inputs() const override { return FOREGROUND; }
+    void detect(AnalysisContext& context, std::vector<DetectionResult>& results) override;
+};
+
+// Foreground blobs whose box overlaps an include zone (by default the
+// central guard area).
+class IntrusionDetector : public Detector {
+public:
+    IntrusionDetector() : Detector("intrusion") {}
+
+    Inputs inputs() const override { return FOREGROUND; }
+    void detect(AnalysisContext& context, std::vector<DetectionResult>& results) override;
+};
+
+// Fire-coloured regions scored by colour area, texture, and shape. Works on
+// regions(), so it can be gated to where the foreground changed.
+class FireDetector : public Detector {
+public:
+    FireDetector();
+
+    // Reads the frame only; the candidates' bounding area is converted to
+    // grey locally.
+    Inputs inputs() const override { return 0; }
+    void detect(AnalysisContext& context, std::vector<DetectionResult>& results) override;
+
+    // Mean Sobel magnitude / 255, clamped to [0, 1].
+    static double textureFeature(const cv::Mat& image);
+    static double shapeFeature(const std::vector<cv::Point>& contour);
+
+private:
+    // Declared first so it outlives the mask, which is region-sized.
+    ScratchAllocator m_colorMaskAllocator;
+    cv::Mat m_colorMask;
+    BlobExtractor m_blobs;
+    GradientEnergyMap m_gradients;
+};
+
+// Camera faults and tampering, from a SceneModel of the whole view: a
+// frozen picture, a covered lens, lost focus, and a camera pointed elsewhere.
+// A condition is reported once it has held for a number of frames; the
+// result covers the whole frame.
+class EquipmentFailureDetector : public Detector {
+public:
+    EquipmentFailureDetector() : Detector("equipment") {}
+
+    // Samples the frame directly.
+    Inputs inputs() const override { return 0; }
+    void detect(AnalysisContext& context, std::vector<DetectionResult>& results) override;
+
+private:
+    enum Fault {
+        NONE,
+        FROZEN,
+        OCCLUDED,
+        DEFOCUSED,
+        MOVED
+    };
+
+    SceneModel m_scene;
+    int m_identicalFrames = 0;
+    Fault m_fault = NONE;
+    int m_faultFrames = 0;
+};
+
+}
@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include "dnn_detector.h"
+#include "metrics.h"
+
+#if defined(ARCTICOWL_WITH_DNN)
+#include <opencv2/dnn.hpp>
+#define ARCTICOWL_DNN_AVAILABLE 1
+#endif
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+// Letterbox padding, as used when YOLO models are trained.
+const cv::Scalar kPadColor = cv::Scalar::all(114);
+
+// Results carry their class name as a plain pointer and may outlive the
+// queue that produced them, so names are kept until the process exits.
+const char* internLabel(const std::string& text)
+{
+    static std::mutex mutex;
+    static auto* labels = new std::set<std::string>();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return labels->insert(text).first->c_str();
+}
+
+}
+
+#ifdef ARCTICOWL_DNN_AVAILABLE
+struct DnnInferenceQueue::Model {
+    cv::dnn::Net net;
+    std::vector<std::string> outputNames;
+    cv::Mat blob;
+};
+#else
+struct DnnInferenceQueue::Model {};
+#endif
+
+bool DnnInferenceQueue::Client::submit(const cv::Mat& frame)
+{
+    CV_Assert(frame.type() == CV_8UC3);
+
+    if (m_busy.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Keep the aspect ratio and pad the rest; the inverse is applied to the
+    // boxes.
+    const int size = m_queue->m_options.inputSize;
+    const float scale = std::min(static_cast<float>(size) / frame.cols, static_cast<float>(size) / frame.rows);
+    const int width = std::max(1, static_cast<int>(std::lround(frame.cols * scale)));
+    const int height = std::max(1, static_cast<int>(std::lround(frame.rows * scale)));
+    const int padX = (size - width) / 2;
+    const int padY = (size - height) / 2;
+
+    m_input.create(size, size, CV_8UC3);
+    m_input.setTo(kPadColor);
+    cv::Mat content = m_input(cv::Rect(padX, padY, width, height));
+    cv::resize(frame, content, content.size(), 0, 0, cv::INTER_LINEAR);
+
+    m_scale = scale;
+    m_padding = cv::Point2f(static_cast<float>(padX), static_cast<float>(padY));
+    m_frameSize = frame.size();
+
+    m_busy.store(true, std::memory_order_release);
+    m_queue->enqueue(shared_from_this());
+    return true;
+}
+
+bool DnnInferenceQueue::Client::takeResults(std::vector<Object>& objects)
+{
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    if (!m_ready) {
+        return false;
+    }
+
+    objects.swap(m_results);
+    m_ready = false;
+    return true;
+}
+
+bool DnnInferenceQueue::isSupported()
+{
+#ifdef ARCTICOWL_DNN_AVAILABLE
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<DnnInferenceQueue> DnnInferenceQueue::create(const Options& options)
+{
+#ifdef ARCTICOWL_DNN_AVAILABLE
+    try {
+        auto model = std::make_unique<Model>();
+        model->net = cv::dnn::readNetFromONNX(options.modelPath);
+        if (model->net.empty()) {
+            std::cerr << "Failed to load DNN model: " << options.modelPath << std::endl;
+            return nullptr;
+        }
+        model->net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        model->net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        model->outputNames = model->net.getUnconnectedOutLayersNames();
+
+        std::shared_ptr<DnnInferenceQueue> queue(new DnnInferenceQueue(options));
+        queue->m_model = std::move(model);
+        queue->m_thread = std::thread(&DnnInferenceQueue::inferenceLoop, queue.get());
+        return queue;
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error while loading DNN model " << options.modelPath << ": " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error while loading DNN model " << options.modelPath << ": " << e.what() << std::endl;
+    }
+    return nullptr;
+#else
+    std::cerr << "Object detection is not available: built without ARCTICOWL_WITH_DNN." << std::endl;
+    return nullptr;
+#endif
+}
+
+DnnInferenceQueue::DnnInferenceQueue(const Options& options)
+    : m_options(options)
+    , m_batchLimit(std::max(1, options.maxBatch))
+{
+    m_options.inputSize = std::max(32, m_options.inputSize);
+    m_options.batchWindowMs = std::max(0, m_options.batchWindowMs);
+
+    auto& registry = MetricsRegistry::instance();
+    m_inferenceLatency = &registry.histogram("arcticowl_dnn_inference_seconds",
+                                             "Time spent in one batched object detection forward pass.");
+    m_batchFrames = &registry.histogram("arcticowl_dnn_batch_frames",
+                                        "Frames per object detection forward pass.", "",
+                                        {1.0, 2.0, 4.0, 8.0, 16.0, 32.0});
+}
+
+DnnInferenceQueue::~DnnInferenceQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::shared_ptr<DnnInferenceQueue::Client> DnnInferenceQueue::connect()
+{
+    return std::shared_ptr<Client>(new Client(this));
+}
+
+std::string DnnInferenceQueue::className(int classId) const
+{
+    if (classId >= 0 && classId < static_cast<int>(m_options.classNames.size())) {
+        return m_options.classNames[static_cast<std::size_t>(classId)];
+    }
+    return "class " + std::to_string(classId);
+}
+
+void DnnInferenceQueue::enqueue(std::shared_ptr<Client> client)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            client->m_busy = false;
+            return;
+        }
+        m_pending.push_back(std::move(client));
+    }
+    m_wakeCv.notify_one();
+}
+
+void DnnInferenceQueue::inferenceLoop()
+{
+    std::vector<std::shared_ptr<Client>> batch;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCv.wait(lock, [this]() { return m_stopping || !m_pending.empty(); });
+            // Cameras run out of phase; give the others a moment to add their
+            // frames to this pass.
+            m_wakeCv.wait_for(lock, std::chrono::milliseconds(m_options.batchWindowMs), [this]() {
+                return m_stopping || static_cast<int>(m_pending.size()) >= m_batchLimit;
+            });
+            if (m_stopping) {
+                for (auto& client : m_pending) {
+                    client->m_busy = false;
+                }
+                m_pending.clear();
+                return;
+            }
+
+            const auto count = static_cast<std::ptrdiff_t>(
+                std::min(m_pending.size(), static_cast<std::size_t>(m_batchLimit)));
+            batch.assign(m_pending.begin(), m_pending.begin() + count);
+            m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+        }
+
+        runBatch(batch);
+        batch.clear();
+    }
+}
+
+void DnnInferenceQueue::runBatch(const std::vector<std::shared_ptr<Client>>& batch)
+{
+    if (forward(batch)) {
+        return;
+    }
+
+    // Models exported with a fixed batch of 1 reject larger blobs; remember
+    // that and go frame by frame from now on.
+    std::cerr << "DNN model does not accept a batch of " << batch.size()
+              << " frames; running frames one at a time." << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batchLimit = 1;
+    }
+
+    std::vector<std::shared_ptr<Client>> single(1);
+    for (const auto& client : batch) {
+        single.front() = client;
+        forward(single);
+    }
+}
+
+bool DnnInferenceQueue::forward(const std::vector<std::shared_ptr<Client>>& batch)
+{
+#ifdef ARCTICOWL_DNN_AVAILABLE
+    const int size = static_cast<int>(batch.size());
+    bool finished = false;
+
+    try {
+        m_inputs.clear();
+        for (const auto& client : batch) {
+            m_inputs.push_back(client->m_input);
+        }
+
+        // Scaled to [0, 1] and swapped to RGB, as YOLO exports expect.
+        cv::dnn::blobFromImages(m_inputs, m_model->blob, 1.0 / 255.0, cv::Size(), cv::Scalar(), true, false);
+        m_model->net.setInput(m_model->blob);
+        {
+            StageTimer timer(m_inferenceLatency);
+            m_model->net.forward(m_outputs, m_model->outputNames);
+        }
+
+        const cv::Mat& output = m_outputs.front();
+        if (output.dims != 3 || output.size[0] != size) {
+            CV_Error(cv::Error::StsUnmatchedSizes, "DNN output does not match the batch");
+        }
+        finished = true;
+    } catch (const cv::Exception& e) {
+        if (size > 1) {
+            return false;
+        }
+        std::cerr << "OpenCV error during object detection inference: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        if (size > 1) {
+            return false;
+        }
+        std::cerr << "Error during object detection inference: " << e.what() << std::endl;
+    }
+
+    if (finished) {
+        m_batchFrames->observe(size);
+        for (int image = 0; image < size; ++image) {
+            Client& client = *batch[static_cast<std::size_t>(image)];
+            std::vector<Object> objects;
+            try {
+                parseOutput(m_outputs.front(), image, client, objects);
+            } catch (const cv::Exception& e) {
+                std::cerr << "OpenCV error while reading object detection output: " << e.what() << std::endl;
+                objects.clear();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(client.m_resultsMutex);
+                client.m_results.swap(objects);
+                client.m_ready = true;
+            }
+            client.m_busy.store(false, std::memory_order_release);
+        }
+        return true;
+    }
+#endif
+
+    // A frame that failed on its own is dropped; the client keeps its last
+    // results and may submit again.
+    for (const auto& client : batch) {
+        client->m_busy.store(false, std::memory_order_release);
+    }
+    return true;
+}
+
+#ifdef ARCTICOWL_DNN_AVAILABLE
+void DnnInferenceQueue::parseOutput(const cv::Mat& output, int image, const Client& client,
+                                    std::vector<Object>& objects)
+{
+    // YOLOv8 puts the attributes on the short axis and has no objectness.
+    const bool transposed = output.size[1] < output.size[2];
+    const int candidates = transposed ? output.size[2] : output.size[1];
+    const int attributes = transposed ? output.size[1] : output.size[2];
+    const int firstClass = transposed ? 4 : 5;
+    const int classCount = attributes - firstClass;
+    if (classCount <= 0) {
+        CV_Error(cv::Error::StsBadSize, "DNN output has no class scores");
+    }
+
+    const float* data = output.ptr<float>(image);
+    auto at = [data, transposed, candidates, attributes](int candidate, int attribute) {
+        return transposed ? data[attribute * candidates + candidate] : data[candidate * attributes + attribute];
+    };
+
+    // Boxes of different classes are moved apart so one NMS pass never
+    // suppresses across classes.
+    const int classOffset = 4 * m_options.inputSize;
+    const float threshold = m_options.confidenceThreshold;
+
+    m_boxes.clear();
+    m_scores.clear();
+    m_classIds.clear();
+    for (int candidate = 0; candidate < candidates; ++candidate) {
+        const float objectness = transposed ? 1.0f : at(candidate, 4);
+        if (objectness < threshold) continue;
+
+        int bestClass = 0;
+        float bestScore = at(candidate, firstClass);
+        for (int c = 1; c < classCount; ++c) {
+            const float score = at(candidate, firstClass + c);
+            if (score > bestScore) {
+                bestScore = score;
+                bestClass = c;
+            }
+        }
+
+        const float confidence = objectness * bestScore;
+        if (confidence < threshold) continue;
+
+        const float width = at(candidate, 2);
+        const float height = at(candidate, 3);
+        const int left = static_cast<int>(std::lround(at(candidate, 0) - width / 2.0f));
+        const int top = static_cast<int>(std::lround(at(candidate, 1) - height / 2.0f));
+        m_boxes.emplace_back(left + bestClass * classOffset, top, static_cast<int>(std::lround(width)),
+                             static_cast<int>(std::lround(height)));
+        m_scores.push_back(confidence);
+        m_classIds.push_back(bestClass);
+    }
+
+    cv::dnn::NMSBoxes(m_boxes, m_scores, threshold, m_options.nmsThreshold, m_kept);
+
+    // Undo the class offset and the letterbox, then normalise to the frame.
+    const cv::Rect2f unit(0.0f, 0.0f, 1.0f, 1.0f);
+    objects.clear();
+    for (const int index : m_kept) {
+        const cv::Rect& box = m_boxes[static_cast<std::size_t>(index)];
+        const int classId = m_classIds[static_cast<std::size_t>(index)];
+        const float x = (box.x - classId * classOffset - client.m_padding.x) / client.m_scale;
+        const float y = (box.y - client.m_padding.y) / client.m_scale;
+
+        Object object;
+        object.classId = classId;
+        object.label = classLabel(classId);
+        object.confidence = m_scores[static_cast<std::size_t>(index)];
+        object.box = cv::Rect2f(x / client.m_frameSize.width, y / client.m_frameSize.height,
+                                box.width / client.m_scale / client.m_frameSize.width,
+                                box.height / client.m_scale / client.m_frameSize.height) & unit;
+        if (object.box.area() > 0.0f) {
+            objects.push_back(object);
+        }
+    }
+}
+#endif
+
+const char* DnnInferenceQueue::classLabel(int classId)
+{
+    if (classId < 0) {
+        return "";
+    }
+    if (static_cast<std::size_t>(classId) >= m_classLabels.size()) {
+        m_classLabels.resize(static_cast<std::size_t>(classId) + 1, nullptr);
+    }
+
+    const char*& label = m_classLabels[static_cast<std::size_t>(classId)];
+    if (!label) {
+        label = internLabel(className(classId));
+    }
+    return label;
+}
+
+DnnDetector::DnnDetector(std::shared_ptr<DnnInferenceQueue> queue, int interval)
+    : Detector("object")
+    , m_queue(std::move(queue))
+    , m_interval(std::max(1, interval))
+{
+    if (m_queue) {
+        m_client = m_queue->connect();
+    }
+}
+
+void DnnDetector::detect(AnalysisContext& context, std::vector<DetectionResult>& results)
+{
+    const cv::Mat& frame = context.frame();
+    if (frame.empty() || !m_client) {
+        return;
+    }
+
+    try {
+        // A frame still in flight postpones the next submission rather than
+        // queueing behind it.
+        if (--m_framesUntilSubmit <= 0 && m_client->submit(frame)) {
+            m_framesUntilSubmit = m_interval;
+        }
+        m_client->takeResults(m_objects);
+
+        const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+        for (const auto& object : m_objects) {
+            const int x0 = static_cast<int>(std::lround(object.box.x * frame.cols));
+            const int y0 = static_cast<int>(std::lround(object.box.y * frame.rows));
+            const int x1 = static_cast<int>(std::lround((object.box.x + object.box.width) * frame.cols));
+            const int y1 = static_cast<int>(std::lround((object.box.y + object.box.height) * frame.rows));
+
+            DetectionResult result;
+            result.type = DetectionResult::OBJECT;
+            result.boundingBox = cv::Rect(x0, y0, x1 - x0, y1 - y0) & frameRect;
+            if (result.boundingBox.empty()) continue;
+            result.confidence = object.confidence;
+            result.classId = object.classId;
+            result.description = object.label;
+            results.push_back(result);
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error during object detection: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during object detection: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error during object detection" << std::endl;
+    }
+}
+
+}
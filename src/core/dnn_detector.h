@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "detector.h"
+
+namespace ArcticOwl::Core {
+
+class Histogram;
+
+// CPU object detection with an ONNX model through cv::dnn, shared by any
+// number of cameras. Each camera submits frames through its own Client;
+// they are letterboxed on the submitting thread, and one inference thread
+// gathers whatever is queued into a single forward pass of up to maxBatch
+// frames. Only available in builds with ARCTICOWL_WITH_DNN; elsewhere
+// create() always fails.
+class DnnInferenceQueue {
+public:
+    struct Options {
+        // YOLO-style ONNX model: output [batch, boxes, 5 + classes] with
+        // objectness (YOLOv5) or [batch, 4 + classes, boxes] without
+        // (YOLOv8).
+        std::string modelPath;
+        // Class names by index; classes without one are named by number.
+        std::vector<std::string> classNames;
+        // Side of the square network input in pixels.
+        int inputSize = 640;
+        // Frames per forward pass. Models exported with a fixed batch of 1
+        // are detected on the first batch and then run frame by frame.
+        int maxBatch = 8;
+        // How long the first queued frame waits for others to join it.
+        int batchWindowMs = 10;
+        float confidenceThreshold = 0.25f;
+        float nmsThreshold = 0.45f;
+    };
+
+    // Detected object; the box is normalised to the submitted frame.
+    struct Object {
+        int classId = 0;
+        // className(classId), interned for the life of the process.
+        const char* label = "";
+        float confidence = 0.0f;
+        cv::Rect2f box;
+    };
+
+    // One camera's slot: at most one of its frames is queued or in flight.
+    class Client : public std::enable_shared_from_this<Client> {
+    public:
+        // Letterboxes frame (CV_8UC3 BGR) and queues it. Returns false
+        // without copying while the previous frame has not finished.
+        bool submit(const cv::Mat& frame);
+        // Objects of the latest finished frame; false if no frame finished
+        // since the last call.
+        bool takeResults(std::vector<Object>& objects);
+
+    private:
+        friend class DnnInferenceQueue;
+
+        // The queue must outlive the client; DnnDetector holds both.
+        explicit Client(DnnInferenceQueue* queue) : m_queue(queue) {}
+
+        DnnInferenceQueue* m_queue;
+        // Written by submit() while idle, read by the inference thread while
+        // busy.
+        cv::Mat m_input;
+        float m_scale = 1.0f;
+        cv::Point2f m_padding;
+        cv::Size m_frameSize;
+        std::atomic<bool> m_busy{false};
+
+        std::mutex m_resultsMutex;
+        std::vector<Object> m_results;
+        bool m_ready = false;
+    };
+
+    static bool isSupported();
+    // Loads the model and starts the inference thread; nullptr if the model
+    // cannot be loaded.
+    static std::shared_ptr<DnnInferenceQueue> create(const Options& options);
+    ~DnnInferenceQueue();
+
+    DnnInferenceQueue(const DnnInferenceQueue&) = delete;
+    DnnInferenceQueue& operator=(const DnnInferenceQueue&) = delete;
+
+    std::shared_ptr<Client> connect();
+
+    const Options& options() const { return m_options; }
+    std::string className(int classId) const;
+
+private:
+    struct Model;
+
+    explicit DnnInferenceQueue(const Options& options);
+
+    void enqueue(std::shared_ptr<Client> client);
+    void inferenceLoop();
+    void runBatch(const std::vector<std::shared_ptr<Client>>& batch);
+    // Forward pass over batch; false if the model rejected the batch size.
+    bool forward(const std::vector<std::shared_ptr<Client>>& batch);
+    void parseOutput(const cv::Mat& output, int image, const Client& client, std::vector<Object>& objects);
+    const char* classLabel(int classId);
+
+    Options m_options;
+    std::unique_ptr<Model> m_model;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCv;
+    std::vector<std::shared_ptr<Client>> m_pending;
+    int m_batchLimit = 1;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    // Inference thread only.
+    std::vector<cv::Mat> m_inputs;
+    std::vector<cv::Mat> m_outputs;
+    std::vector<cv::Rect> m_boxes;
+    std::vector<float> m_scores;
+    std::vector<int> m_classIds;
+    std::vector<int> m_kept;
+    std::vector<const char*> m_classLabels;
+    Histogram* m_inferenceLatency = nullptr;
+    Histogram* m_batchFrames = nullptr;
+};
+
+// Objects from a shared DnnInferenceQueue, as DetectionResult::OBJECT with
+// the class name as description. Every interval-th frame is submitted unless
+// the previous one is still in flight, so the model runs at a lower cadence
+// than capture and never queues up. The last finished result is reported on
+// every frame until the next one arrives, so boxes lag by the inference
+// latency.
+class DnnDetector : public Detector {
+public:
+    DnnDetector(std::shared_ptr<DnnInferenceQueue> queue, int interval);
+
+    // Reads the frame only.
+    Inputs inputs() const override { return 0; }
+    void detect(AnalysisContext& context, std::vector<DetectionResult>& results) override;
+
+private:
+    std::shared_ptr<DnnInferenceQueue> m_queue;
+    std::shared_ptr<DnnInferenceQueue::Client> m_client;
+    int m_interval;
+    int m_framesUntilSubmit = 0;
+    std::vector<DnnInferenceQueue::Object> m_objects;
+};
+
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "fire_color_mask.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+// OpenCV's 8-bit BGR->HSV conversion is integer arithmetic with 12-bit
+// reciprocal tables:
+//   s = (diff * sdiv[v] + 2048) >> 12
+//   h = ((g - b) * hdiv[diff] + 2048) >> 12 (+180 if negative), when v == r
+// Hues in [0, 15] or [160, 180] only arise when red is the maximum (the
+// green and blue branches land in [30, 150]), so the colour test reduces to
+// comparing the same products against fixed bounds, with no division and no
+// HSV image. Using the same tables keeps every rounding decision identical.
+constexpr int kHsvShift = 12;
+constexpr int kHsvRound = 1 << (kHsvShift - 1);
+constexpr int kMinValue = 100;
+// s >= 100
+constexpr int kMinSaturationProduct = (100 << kHsvShift) - kHsvRound;
+// h <= 15 before wrapping
+constexpr int kLowerHueLimit = (16 << kHsvShift) - kHsvRound;
+// h + 180 >= 160 after wrapping, i.e. h >= -20
+constexpr int kUpperHueFloor = -(20 << kHsvShift) - kHsvRound;
+// Below this many pixels a frame is not worth splitting.
+constexpr int kPixelsPerStripe = 64 * 1024;
+
+struct HsvTables {
+    int sdiv[256];
+    int hdiv[256];
+
+    HsvTables()
+    {
+        sdiv[0] = hdiv[0] = 0;
+        for (int i = 1; i < 256; ++i) {
+            sdiv[i] = cvRound((255 << kHsvShift) / (1.0 * i));
+            hdiv[i] = cvRound((180 << kHsvShift) / (6.0 * i));
+        }
+    }
+};
+
+const HsvTables& hsvTables()
+{
+    static const HsvTables tables;
+    return tables;
+}
+
+inline uchar firePixel(const uchar* pixel, const HsvTables& tables)
+{
+    const int b = pixel[0];
+    const int g = pixel[1];
+    const int r = pixel[2];
+    const int v = std::max(std::max(b, g), r);
+    if (v != r || v < kMinValue) {
+        return 0;
+    }
+
+    const int diff = v - std::min(b, g);
+    const int hue = (g - b) * tables.hdiv[diff];
+    const bool match = diff * tables.sdiv[v] >= kMinSaturationProduct
+                    && hue < kLowerHueLimit && hue >= kUpperHueFloor;
+    return match ? 255 : 0;
+}
+
+#if CV_SIMD128
+// Four lanes of the scalar test above; returns all-ones where it passes.
+inline cv::v_int32x4 fireLanes(const cv::v_int32x4& v, const cv::v_int32x4& diff, const cv::v_int32x4& gb,
+                               const HsvTables& tables)
+{
+    const cv::v_int32x4 saturation = diff * cv::v_lut(tables.sdiv, v);
+    const cv::v_int32x4 hue = gb * cv::v_lut(tables.hdiv, diff);
+    return (saturation >= cv::v_setall_s32(kMinSaturationProduct))
+         & (hue < cv::v_setall_s32(kLowerHueLimit))
+         & (hue >= cv::v_setall_s32(kUpperHueFloor));
+}
+#endif
+
+void fireColorRows(const cv::Mat& bgr, cv::Mat& mask, const cv::Range& rows)
+{
+    const HsvTables& tables = hsvTables();
+
+    for (int y = rows.start; y < rows.end; ++y) {
+        const uchar* src = bgr.ptr<uchar>(y);
+        uchar* dst = mask.ptr<uchar>(y);
+        int x = 0;
+
+#if CV_SIMD128
+        const cv::v_uint8x16 minValue = cv::v_setall_u8(kMinValue);
+        for (; x <= bgr.cols - 16; x += 16) {
+            cv::v_uint8x16 b, g, r;
+            cv::v_load_deinterleave(src + 3 * x, b, g, r);
+
+            const cv::v_uint8x16 v = cv::v_max(cv::v_max(b, g), r);
+            const cv::v_uint8x16 gate = (v == r) & (v >= minValue);
+            // Most of a typical scene is not bright and red-dominant.
+            if (!cv::v_check_any(gate)) {
+                cv::v_store(dst + x, cv::v_setzero_u8());
+                continue;
+            }
+
+            const cv::v_uint8x16 diff = v - cv::v_min(b, g);
+
+            cv::v_uint16x8 v16[2], diff16[2], g16[2], b16[2];
+            cv::v_expand(v, v16[0], v16[1]);
+            cv::v_expand(diff, diff16[0], diff16[1]);
+            cv::v_expand(g, g16[0], g16[1]);
+            cv::v_expand(b, b16[0], b16[1]);
+
+            cv::v_int32x4 lanes[4];
+            for (int half = 0; half < 2; ++half) {
+                cv::v_uint32x4 v32[2], diff32[2];
+                cv::v_int32x4 gb32[2];
+                cv::v_expand(v16[half], v32[0], v32[1]);
+                cv::v_expand(diff16[half], diff32[0], diff32[1]);
+                cv::v_expand(cv::v_reinterpret_as_s16(g16[half]) - cv::v_reinterpret_as_s16(b16[half]),
+                             gb32[0], gb32[1]);
+                for (int quarter = 0; quarter < 2; ++quarter) {
+                    lanes[half * 2 + quarter] = fireLanes(cv::v_reinterpret_as_s32(v32[quarter]),
+                                                          cv::v_reinterpret_as_s32(diff32[quarter]),
+                                                          gb32[quarter], tables);
+                }
+            }
+
+            const cv::v_int8x16 match = cv::v_pack(cv::v_pack(lanes[0], lanes[1]), cv::v_pack(lanes[2], lanes[3]));
+            cv::v_store(dst + x, cv::v_reinterpret_as_u8(match) & gate);
+        }
+#endif
+
+        for (; x < bgr.cols; ++x) {
+            dst[x] = firePixel(src + 3 * x, tables);
+        }
+    }
+}
+
+}
+
+void fireColorMask(const cv::Mat& bgr, cv::Mat& mask)
+{
+    CV_Assert(bgr.type() == CV_8UC3);
+
+    mask.create(bgr.size(), CV_8UC1);
+    if (bgr.empty()) {
+        return;
+    }
+
+    const double stripes = std::max(1.0, static_cast<double>(bgr.total()) / kPixelsPerStripe);
+    cv::parallel_for_(cv::Range(0, bgr.rows), [&bgr, &mask](const cv::Range& rows) {
+        fireColorRows(bgr, mask, rows);
+    }, stripes);
+}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Writes 255 into mask (CV_8UC1, frame-sized) wherever a CV_8UC3 BGR pixel
+// falls in the fire colour range: H in [0, 15] or [160, 180] with S and V of
+// at least 100, as produced by cvtColor(COLOR_BGR2HSV). The result is
+// bit-identical to the cvtColor/inRange/bitwise_or chain but makes one pass
+// over the frame without the HSV temporary. Rows are split into stripes and
+// run with cv::parallel_for_.
+void fireColorMask(const cv::Mat& bgr, cv::Mat& mask);
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// A captured image plus where and when it came from. Stages hand Frames on by
+// value; copying one only copies the cv::Mat header, never the pixels.
+struct Frame {
+    cv::Mat image;
+    // CameraManager index of the source, -1 outside a manager.
+    int cameraIndex = -1;
+    // Per-source count of grabbed frames, starting at 1. Frames skipped before
+    // decoding still consume a number, so gaps show where frames were shed.
+    std::uint64_t sequence = 0;
+    // Monotonic time at which grab() returned.
+    std::chrono::steady_clock::time_point captureTime;
+    // Source presentation timestamp in milliseconds.
+    double ptsMs = 0.0;
+    // Frames of this source that did not reach the current stage since the
+    // previous one that did. Each stage rewrites it on receipt.
+    std::uint64_t droppedBefore = 0;
+
+    bool empty() const { return image.empty(); }
+
+    // Seconds from capture until now.
+    double age() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - captureTime).count();
+    }
+};
+
+// Turns the sequence numbers one stage receives into a count of frames lost
+// upstream of it. Not thread-safe; keep one per stage and source.
+class FrameGapTracker {
+public:
+    // Returns how many sequence numbers were skipped since the last call.
+    std::uint64_t observe(std::uint64_t sequence)
+    {
+        const std::uint64_t gap = (m_last > 0 && sequence > m_last) ? sequence - m_last - 1 : 0;
+        m_last = sequence;
+        return gap;
+    }
+
+    void reset() { m_last = 0; }
+
+private:
+    std::uint64_t m_last = 0;
+};
+
+}
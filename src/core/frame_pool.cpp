@@ -0,0 +1,71 @@
+#include "frame_pool.h"
+
+namespace ArcticOwl::Core {
+
+FramePool::FramePool(std::size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+{
+}
+
+void FramePool::configure(cv::Size size, int type)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_buffers.clear();
+    m_buffers.reserve(m_capacity);
+    for (std::size_t i = 0; i < m_capacity; ++i) {
+        m_buffers.emplace_back(size, type);
+    }
+
+    m_next = 0;
+    m_size = size;
+    m_type = type;
+}
+
+bool FramePool::matches(cv::Size size, int type) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_buffers.empty() && m_size == size && m_type == type;
+}
+
+bool FramePool::isConfigured() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_buffers.empty();
+}
+
+cv::Mat FramePool::acquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+        const std::size_t index = (m_next + i) % m_buffers.size();
+        if (isExclusive(m_buffers[index])) {
+            m_next = (index + 1) % m_buffers.size();
+            return m_buffers[index];
+        }
+    }
+
+    return cv::Mat();
+}
+
+std::size_t FramePool::available() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::size_t count = 0;
+    for (const auto& buffer : m_buffers) {
+        if (isExclusive(buffer)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool FramePool::isExclusive(const cv::Mat& buffer)
+{
+    // Atomic read of the refcount OpenCV maintains with CV_XADD.
+    return buffer.u != nullptr && CV_XADD(&buffer.u->refcount, 0) == 1;
+}
+
+}
\ No newline at end of file
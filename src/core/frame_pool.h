@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Fixed set of preallocated frame buffers. Buffers are handed out as ordinary
+// cv::Mat headers, so cv::Mat's own reference count tracks consumers: a buffer
+// becomes reusable as soon as every header except the pool's has been released.
+// Frames obtained from the pool are shared, not copied; treat them as read-only
+// unless you are the last stage that touches them.
+class FramePool {
+public:
+    explicit FramePool(std::size_t capacity = 8);
+
+    // Allocates every buffer for the given geometry, replacing older buffers.
+    // Frames still held by consumers stay valid and are freed by OpenCV later.
+    void configure(cv::Size size, int type);
+    bool matches(cv::Size size, int type) const;
+    bool isConfigured() const;
+
+    // Returns a buffer no consumer references, or an empty Mat when the pool is
+    // unconfigured or every buffer is still in use.
+    cv::Mat acquire();
+
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t available() const;
+
+private:
+    static bool isExclusive(const cv::Mat& buffer);
+
+    std::size_t m_capacity;
+    std::vector<cv::Mat> m_buffers;
+    std::size_t m_next = 0;
+    cv::Size m_size;
+    int m_type = -1;
+    mutable std::mutex m_mutex;
+};
+
+}
\ No newline at end of file
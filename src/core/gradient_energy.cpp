@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "gradient_energy.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+// Below this many pixels an area is not worth splitting.
+constexpr int kPixelsPerStripe = 64 * 1024;
+
+// Sobel gradients of one output row from the three padded grey rows around
+// it; every pointer is at output column 0, so index -1 is the left border.
+void magnitudeRow(const uchar* above, const uchar* row, const uchar* below, float* out, int width)
+{
+    int x = 0;
+
+#if CV_SIMD128
+    // 8 pixels per step: 16-bit differences cannot overflow (|g| <= 1020),
+    // the squares and the root are single precision.
+    auto load = [](const uchar* p) { return cv::v_reinterpret_as_s16(cv::v_load_expand(p)); };
+    for (; x <= width - 8; x += 8) {
+        const cv::v_int16x8 a0 = load(above + x - 1), a1 = load(above + x), a2 = load(above + x + 1);
+        const cv::v_int16x8 r0 = load(row + x - 1), r2 = load(row + x + 1);
+        const cv::v_int16x8 b0 = load(below + x - 1), b1 = load(below + x), b2 = load(below + x + 1);
+
+        const cv::v_int16x8 dr = r2 - r0;
+        const cv::v_int16x8 gx = (a2 - a0) + dr + dr + (b2 - b0);
+        const cv::v_int16x8 gy = (b0 + b1 + b1 + b2) - (a0 + a1 + a1 + a2);
+
+        cv::v_int32x4 gx32[2], gy32[2];
+        cv::v_expand(gx, gx32[0], gx32[1]);
+        cv::v_expand(gy, gy32[0], gy32[1]);
+        for (int half = 0; half < 2; ++half) {
+            const cv::v_float32x4 fx = cv::v_cvt_f32(gx32[half]);
+            const cv::v_float32x4 fy = cv::v_cvt_f32(gy32[half]);
+            cv::v_store(out + x + 4 * half, cv::v_sqrt(fx * fx + fy * fy));
+        }
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const int gx = (above[x + 1] - above[x - 1]) + 2 * (row[x + 1] - row[x - 1]) + (below[x + 1] - below[x - 1]);
+        const int gy = (below[x - 1] + 2 * below[x] + below[x + 1]) - (above[x - 1] + 2 * above[x] + above[x + 1]);
+        out[x] = std::sqrt(static_cast<float>(gx * gx + gy * gy));
+    }
+}
+
+}
+
+GradientEnergyMap::GradientEnergyMap()
+{
+    // Every plane is the size of the candidate area, which changes with the
+    // scene.
+    m_grayAllocator.attach(m_gray);
+    m_paddedAllocator.attach(m_padded);
+    m_magnitudeAllocator.attach(m_magnitude);
+    m_integralAllocator.attach(m_integral);
+}
+
+void GradientEnergyMap::compute(const cv::Mat& image, const cv::Rect& area)
+{
+    CV_Assert(image.type() == CV_8UC3 || image.type() == CV_8UC1);
+
+    m_area = area & cv::Rect(0, 0, image.cols, image.rows);
+    if (m_area.empty()) {
+        m_integral.release();
+        return;
+    }
+
+    // Real neighbours where the image has them, reflected ones at its edges,
+    // as cv::Sobel does on a whole frame.
+    const cv::Rect padded = cv::Rect(m_area.x - 1, m_area.y - 1, m_area.width + 2, m_area.height + 2)
+                          & cv::Rect(0, 0, image.cols, image.rows);
+    if (image.channels() == 3) {
+        cv::cvtColor(image(padded), m_gray, cv::COLOR_BGR2GRAY);
+    } else {
+        image(padded).copyTo(m_gray);
+    }
+    cv::copyMakeBorder(m_gray, m_padded,
+                       padded.y - (m_area.y - 1), (m_area.y + m_area.height + 1) - (padded.y + padded.height),
+                       padded.x - (m_area.x - 1), (m_area.x + m_area.width + 1) - (padded.x + padded.width),
+                       cv::BORDER_REFLECT_101);
+
+    m_magnitude.create(m_area.size(), CV_32FC1);
+    const double stripes = std::max(1.0, static_cast<double>(m_area.area()) / kPixelsPerStripe);
+    cv::parallel_for_(cv::Range(0, m_area.height), [this](const cv::Range& rows) {
+        for (int y = rows.start; y < rows.end; ++y) {
+            magnitudeRow(m_padded.ptr<uchar>(y) + 1, m_padded.ptr<uchar>(y + 1) + 1, m_padded.ptr<uchar>(y + 2) + 1,
+                         m_magnitude.ptr<float>(y), m_area.width);
+        }
+    }, stripes);
+
+    // Double sums: a float integral loses the low bits on large areas.
+    cv::integral(m_magnitude, m_integral, CV_64F);
+}
+
+double GradientEnergyMap::meanMagnitude(const cv::Rect& box) const
+{
+    const cv::Rect clipped = box & m_area;
+    if (clipped.empty() || m_integral.empty()) {
+        return 0.0;
+    }
+
+    const int x0 = clipped.x - m_area.x;
+    const int y0 = clipped.y - m_area.y;
+    const int x1 = x0 + clipped.width;
+    const int y1 = y0 + clipped.height;
+    const double sum = m_integral.at<double>(y1, x1) - m_integral.at<double>(y0, x1)
+                     - m_integral.at<double>(y1, x0) + m_integral.at<double>(y0, x0);
+    return sum / clipped.area();
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include "scratch_allocator.h"
+
+namespace ArcticOwl::Core {
+
+// Sobel (3x3) gradient magnitude over an area of an image, kept as an
+// integral image so the mean over any box inside the area costs four reads.
+// The magnitude is computed in one fixed-point/single-precision SIMD pass
+// over the grey area; pixels just outside it are used for the border where
+// the image has them. Not thread-safe; buffers are reused, also when the
+// area changes size.
+class GradientEnergyMap {
+public:
+    GradientEnergyMap();
+
+    // Computes the map for area (clipped to image) of a CV_8UC3 BGR or
+    // CV_8UC1 grey image.
+    void compute(const cv::Mat& image, const cv::Rect& area);
+    const cv::Rect& area() const { return m_area; }
+
+    // Mean gradient magnitude over box, in image coordinates, clipped to
+    // area(). 0 if nothing is left.
+    double meanMagnitude(const cv::Rect& box) const;
+
+private:
+    // Declared first so they outlive the Mats they back.
+    ScratchAllocator m_grayAllocator;
+    ScratchAllocator m_paddedAllocator;
+    ScratchAllocator m_magnitudeAllocator;
+    ScratchAllocator m_integralAllocator;
+
+    cv::Rect m_area;
+    // Grey area with a one-pixel border.
+    cv::Mat m_gray;
+    cv::Mat m_padded;
+    cv::Mat m_magnitude;
+    // (rows + 1) x (cols + 1) CV_64F sums of m_magnitude.
+    cv::Mat m_integral;
+};
+
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "metrics.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+std::string seriesName(const std::string& name, const std::string& labels)
+{
+    if (labels.empty()) {
+        return name;
+    }
+    return name + "{" + labels + "}";
+}
+
+std::string joinLabels(const std::string& labels, const std::string& extra)
+{
+    if (labels.empty()) {
+        return extra;
+    }
+    return labels + "," + extra;
+}
+
+}
+
+Histogram::Histogram(std::vector<double> upperBounds)
+    : m_upperBounds(std::move(upperBounds))
+    , m_buckets(new std::atomic<std::uint64_t>[m_upperBounds.size() + 1])
+{
+    std::sort(m_upperBounds.begin(), m_upperBounds.end());
+    for (std::size_t i = 0; i <= m_upperBounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value)
+{
+    const auto it = std::lower_bound(m_upperBounds.begin(), m_upperBounds.end(), value);
+    const std::size_t index = static_cast<std::size_t>(it - m_upperBounds.begin());
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    double current = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t Histogram::bucketCount(std::size_t index) const
+{
+    return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+std::vector<double> Histogram::latencyBuckets()
+{
+    return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5};
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, Type type)
+{
+    auto& entry = m_families[name];
+    if (entry.help.empty()) {
+        entry.help = help;
+        entry.type = type;
+    }
+    return entry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& slot = family(name, help, Type::COUNTER).counters[labels];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& slot = family(name, help, Type::GAUGE).gauges[labels];
+    if (!slot) {
+        slot = std::make_unique<Gauge>();
+    }
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels,
+                                      const std::vector<double>& upperBounds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& slot = family(name, help, Type::HISTOGRAM).histograms[labels];
+    if (!slot) {
+        slot = std::make_unique<Histogram>(upperBounds);
+    }
+    return *slot;
+}
+
+std::string MetricsRegistry::renderText() const
+{
+    std::ostringstream out;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, entry] : m_families) {
+        out << "# HELP " << name << " " << entry.help << "\n";
+
+        switch (entry.type) {
+        case Type::COUNTER:
+            out << "# TYPE " << name << " counter\n";
+            for (const auto& [labels, counter] : entry.counters) {
+                out << seriesName(name, labels) << " " << counter->value() << "\n";
+            }
+            break;
+        case Type::GAUGE:
+            out << "# TYPE " << name << " gauge\n";
+            for (const auto& [labels, gauge] : entry.gauges) {
+                out << seriesName(name, labels) << " " << gauge->value() << "\n";
+            }
+            break;
+        case Type::HISTOGRAM:
+            out << "# TYPE " << name << " histogram\n";
+            for (const auto& [labels, histogram] : entry.histograms) {
+                std::uint64_t cumulative = 0;
+                const auto& bounds = histogram->upperBounds();
+                for (std::size_t i = 0; i < bounds.size(); ++i) {
+                    cumulative += histogram->bucketCount(i);
+                    std::ostringstream bound;
+                    bound << bounds[i];
+                    out << seriesName(name + "_bucket", joinLabels(labels, label("le", bound.str())))
+                        << " " << cumulative << "\n";
+                }
+                cumulative += histogram->bucketCount(bounds.size());
+                out << seriesName(name + "_bucket", joinLabels(labels, label("le", "+Inf"))) << " " << cumulative << "\n";
+                out << seriesName(name + "_sum", labels) << " " << histogram->sum() << "\n";
+                out << seriesName(name + "_count", labels) << " " << histogram->count() << "\n";
+            }
+            break;
+        }
+    }
+
+    return out.str();
+}
+
+std::string MetricsRegistry::label(const std::string& key, const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    return key + "=\"" + escaped + "\"";
+}
+
+std::string MetricsRegistry::cameraLabel(int cameraIndex)
+{
+    return label("camera", std::to_string(cameraIndex));
+}
+
+Counter& MetricsRegistry::unboundCounter()
+{
+    static Counter counter;
+    return counter;
+}
+
+Gauge& MetricsRegistry::unboundGauge()
+{
+    static Gauge gauge;
+    return gauge;
+}
+
+Histogram& MetricsRegistry::unboundHistogram()
+{
+    static Histogram histogram(Histogram::latencyBuckets());
+    return histogram;
+}
+
+}
\ No newline at end of file
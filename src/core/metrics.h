@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ArcticOwl::Core {
+
+class Counter {
+public:
+    void inc(std::uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    std::uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+class Gauge {
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+// Cumulative histogram with fixed upper bounds, lock-free on the observe path.
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> upperBounds);
+
+    void observe(double value);
+
+    const std::vector<double>& upperBounds() const { return m_upperBounds; }
+    std::uint64_t bucketCount(std::size_t index) const;
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    double sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    static std::vector<double> latencyBuckets();
+
+private:
+    std::vector<double> m_upperBounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets;
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<double> m_sum{0.0};
+};
+
+// Process-wide registry rendered in the Prometheus text exposition format.
+// Metrics are identified by name plus a label string such as camera="0";
+// asking again for the same pair returns the same instance, so counters stay
+// monotonic across camera restarts. Returned references live as long as the
+// process.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "",
+                         const std::vector<double>& upperBounds = Histogram::latencyBuckets());
+
+    std::string renderText() const;
+
+    static std::string label(const std::string& key, const std::string& value);
+    static std::string cameraLabel(int cameraIndex);
+
+    // Shared instances that are never rendered. Components point their
+    // metrics here until their labels are known, so no unlabelled series is
+    // exported next to the labelled ones.
+    static Counter& unboundCounter();
+    static Gauge& unboundGauge();
+    static Histogram& unboundHistogram();
+
+private:
+    enum class Type {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    struct Family {
+        std::string help;
+        Type type = Type::COUNTER;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, const std::string& help, Type type);
+
+    std::map<std::string, Family> m_families;
+    mutable std::mutex m_mutex;
+};
+
+// Observes the elapsed wall time in seconds into a histogram on destruction.
+class StageTimer {
+public:
+    explicit StageTimer(Histogram* histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~StageTimer()
+    {
+        if (m_histogram) {
+            m_histogram->observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Histogram* m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include <iostream>
+#include <utility>
+
+#include "processing_worker.h"
+#include "thread_pool.h"
+
+namespace ArcticOwl::Core {
+
+ProcessingWorker::ProcessingWorker(VideoProcessor* processor, QObject* parent, std::size_t queueCapacity,
+                                   ThreadPool* pool)
+    : QObject(parent)
+    , m_processor(processor)
+    , m_pool(pool)
+    , m_queue(queueCapacity)
+    , m_isRunning(false)
+{
+}
+
+ProcessingWorker::~ProcessingWorker()
+{
+    stopProcessingSystem();
+}
+
+bool ProcessingWorker::startProcessingSystem()
+{
+    if (m_isRunning) {
+        return true;
+    }
+
+    try {
+        m_queue.reopen();
+        m_processedGaps.reset();
+        m_processedFrames = 0;
+        m_processingFps = 0.0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            m_isRunning = true;
+        }
+
+        if (!m_pool) {
+            m_workerThread = std::thread(&ProcessingWorker::processingLoop, this);
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to start processing worker: " << e.what() << std::endl;
+        m_isRunning = false;
+        return false;
+    }
+}
+
+bool ProcessingWorker::stopProcessingSystem()
+{
+    try {
+        {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            m_isRunning = false;
+        }
+        m_queue.close();
+
+        if (m_workerThread.joinable()) {
+            m_workerThread.join();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_drainMutex);
+            m_drainCv.wait(lock, [this]() { return !m_drainScheduled; });
+        }
+
+        m_queue.clear();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error while stopping processing worker: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error while stopping processing worker." << std::endl;
+    }
+
+    return false;
+}
+
+void ProcessingWorker::submitFrame(const Frame& frame)
+{
+    if (!m_isRunning || frame.empty()) {
+        return;
+    }
+
+    if (!m_queue.push(frame)) {
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        m_queueDropsMetric->inc();
+    }
+
+    if (m_pool) {
+        scheduleDrain();
+    }
+}
+
+void ProcessingWorker::setFrameSink(FrameSink sink)
+{
+    m_frameSink = std::move(sink);
+}
+
+void ProcessingWorker::setMetricsLabels(const std::string& labels)
+{
+    auto& registry = MetricsRegistry::instance();
+    const auto withReason = [&labels](const char* reason) {
+        const std::string reasonLabel = MetricsRegistry::label("reason", reason);
+        return labels.empty() ? reasonLabel : labels + "," + reasonLabel;
+    };
+    const auto withStage = [&labels](const char* stage) {
+        const std::string stageLabel = MetricsRegistry::label("stage", stage);
+        return labels.empty() ? stageLabel : labels + "," + stageLabel;
+    };
+
+    m_detectLatency = &registry.histogram("arcticowl_detect_seconds",
+                                          "Time spent running detection on a frame.", labels);
+    m_sinkLatency = &registry.histogram("arcticowl_sink_seconds",
+                                        "Time spent handing a processed frame to the frame sink.", labels);
+    m_queuedAge = &registry.histogram("arcticowl_frame_age_seconds",
+                                      "Time from grab() until a frame reaches a stage.", withStage("detect_start"));
+    m_processedAge = &registry.histogram("arcticowl_frame_age_seconds",
+                                         "Time from grab() until a frame reaches a stage.", withStage("processed"));
+    m_processedFramesMetric = &registry.counter("arcticowl_processed_frames_total",
+                                                "Frames that completed detection.", labels);
+    m_queueDropsMetric = &registry.counter("arcticowl_dropped_frames_total",
+                                           "Frames dropped before reaching the next stage.",
+                                           withReason("queue_overwrite"));
+    m_previewDropsMetric = &registry.counter("arcticowl_dropped_frames_total",
+                                             "Frames dropped before reaching the next stage.",
+                                             withReason("preview_throttle"));
+    m_fpsMetric = &registry.gauge("arcticowl_processing_fps",
+                                  "Smoothed processing rate in frames per second.", labels);
+}
+
+void ProcessingWorker::processingLoop()
+{
+    Frame frame;
+
+    while (m_queue.waitPop(frame)) {
+        if (!m_isRunning) {
+            break;
+        }
+
+        processFrame(frame);
+        frame = Frame();
+    }
+}
+
+void ProcessingWorker::scheduleDrain()
+{
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    if (!m_isRunning || m_drainScheduled) {
+        return;
+    }
+
+    m_drainScheduled = true;
+    m_pool->submit([this]() { drainOnce(); });
+}
+
+void ProcessingWorker::drainOnce()
+{
+    Frame frame;
+    if (m_isRunning && m_queue.tryPop(frame)) {
+        processFrame(frame);
+        frame = Frame();
+    }
+
+    // Keep the drain token while frames remain so one camera never runs on
+    // two pool threads at once. Deferred, the next frame waits behind the
+    // other cameras' drains already queued; submitted, this worker would pop
+    // it straight back and a busy camera would starve the rest.
+    {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        if (m_isRunning && m_queue.size() > 0) {
+            m_pool->defer([this]() { drainOnce(); });
+            return;
+        }
+        m_drainScheduled = false;
+        // Notify under the lock: stopProcessingSystem, and with it the
+        // destructor, may return as soon as the lock is released.
+        m_drainCv.notify_all();
+    }
+}
+
+cv::Mat ProcessingWorker::acquireDisplayBuffer(const cv::Mat& image)
+{
+    if (!m_displayPool.matches(image.size(), image.type())) {
+        m_displayPool.configure(image.size(), image.type());
+    }
+
+    cv::Mat buffer = m_displayPool.acquire();
+    if (buffer.empty()) {
+        // Every display buffer is still held downstream.
+        buffer.create(image.size(), image.type());
+    }
+    return buffer;
+}
+
+void ProcessingWorker::processFrame(Frame& frame)
+{
+    try {
+        frame.droppedBefore = m_processedGaps.observe(frame.sequence);
+        m_queuedAge->observe(frame.age());
+
+        // Reused, like the processor's own buffers, so steady-state frames
+        // do not allocate here either.
+        std::vector<VideoProcessor::DetectionResult>& results = m_results;
+        results.clear();
+        if (m_processor) {
+            StageTimer timer(m_detectLatency);
+            m_processor->processFrame(frame.image, results);
+        }
+
+        // The capture buffer is shared with VideoCapture::getCurrentFrame, so
+        // it is never written. Overlays go into a copy from the display pool,
+        // made only when there is something to draw.
+        Frame overlaid;
+        if (!results.empty() && (m_frameSink || m_previewEnabled)) {
+            overlaid = frame;
+            overlaid.image = acquireDisplayBuffer(frame.image);
+            frame.image.copyTo(overlaid.image);
+            VideoProcessor::annotateFrame(overlaid.image, results);
+        }
+        const Frame& annotatedFrame = overlaid.empty() ? frame : overlaid;
+        m_processedAge->observe(annotatedFrame.age());
+
+        if (m_frameSink) {
+            StageTimer timer(m_sinkLatency);
+            m_frameSink(annotatedFrame, results);
+        }
+
+        if (m_previewEnabled) {
+            bool post = false;
+            {
+                std::lock_guard<std::mutex> lock(m_previewMutex);
+                if (m_previewPosted) {
+                    // The UI thread has not taken the previous frame yet;
+                    // this one replaces it.
+                    m_previewDropsMetric->inc();
+                }
+                m_preview.frame = annotatedFrame;
+                m_preview.results.assign(results.begin(), results.end());
+                post = !m_previewPosted;
+                m_previewPosted = true;
+            }
+            if (post) {
+                QMetaObject::invokeMethod(this, [this]() { emitPreview(); }, Qt::QueuedConnection);
+            }
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error in processing worker: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in processing worker: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error in processing worker." << std::endl;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (m_processedFrames.load(std::memory_order_relaxed) > 0) {
+        const double elapsed = std::chrono::duration<double>(now - m_lastFrameTime).count();
+        if (elapsed > 0.0) {
+            const double instantFps = 1.0 / elapsed;
+            const double previousFps = m_processingFps.load(std::memory_order_relaxed);
+            const double fps = previousFps == 0.0 ? instantFps : previousFps * 0.9 + instantFps * 0.1;
+            m_processingFps.store(fps, std::memory_order_relaxed);
+            m_fpsMetric->set(fps);
+        }
+    }
+    m_lastFrameTime = now;
+    m_processedFrames.fetch_add(1, std::memory_order_relaxed);
+    m_processedFramesMetric->inc();
+}
+
+void ProcessingWorker::emitPreview()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_previewMutex);
+        std::swap(m_preview, m_shownPreview);
+        m_previewPosted = false;
+    }
+
+    emit frameProcessed(m_shownPreview.frame, m_shownPreview.results);
+    // Hand the pixel buffer back to its pool; the results keep their capacity.
+    m_shownPreview.frame = Frame();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "bounded_queue.h"
+#include "frame.h"
+#include "frame_pool.h"
+#include "metrics.h"
+#include "video_processor.h"
+
+namespace ArcticOwl::Core {
+
+class ThreadPool;
+
+class ProcessingWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FrameSink = std::function<void(const Frame& annotatedFrame,
+                                         const std::vector<VideoProcessor::DetectionResult>& results)>;
+
+    // Without a pool the worker owns a dedicated thread. With a pool, frames
+    // are drained by pool tasks, one frame per task, so cameras share cores
+    // fairly while each processor still sees its frames in order.
+    explicit ProcessingWorker(VideoProcessor* processor, QObject* parent = nullptr, std::size_t queueCapacity = 1,
+                              ThreadPool* pool = nullptr);
+    ~ProcessingWorker();
+
+    bool startProcessingSystem();
+    bool stopProcessingSystem();
+
+    // Thread-safe and non-blocking; intended to be connected to
+    // VideoCapture::frameReady with Qt::DirectConnection. The frame buffer is
+    // shared, not copied, and only read: frames with detections are drawn
+    // into a pooled display buffer for the sink and the preview.
+    void submitFrame(const ArcticOwl::Core::Frame& frame);
+
+    // Invoked on the processing thread for every processed frame. Set before start.
+    void setFrameSink(FrameSink sink);
+
+    // When disabled, frameProcessed is not emitted (e.g. camera not previewed).
+    void setPreviewEnabled(bool enabled) { m_previewEnabled = enabled; }
+
+    // False while a submitted frame is still waiting; lets capture skip decoding
+    // frames that would only overwrite it.
+    bool acceptsFrames() const { return m_isRunning && m_queue.size() < m_queue.capacity(); }
+
+    std::uint64_t droppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+    std::uint64_t processedFrames() const { return m_processedFrames.load(std::memory_order_relaxed); }
+    double processingFps() const { return m_processingFps.load(std::memory_order_relaxed); }
+
+    // Registers the processing metrics under a label set such as camera="0";
+    // until then they are recorded but not exported. Only call while the
+    // worker is stopped.
+    void setMetricsLabels(const std::string& labels);
+
+signals:
+    void frameProcessed(const ArcticOwl::Core::Frame& annotatedFrame,
+                        const std::vector<ArcticOwl::Core::VideoProcessor::DetectionResult>& results);
+
+private:
+    void processingLoop();
+    void scheduleDrain();
+    void drainOnce();
+    void processFrame(Frame& frame);
+    cv::Mat acquireDisplayBuffer(const cv::Mat& image);
+    void emitPreview();
+
+    struct Preview {
+        Frame frame;
+        std::vector<VideoProcessor::DetectionResult> results;
+    };
+
+    VideoProcessor* m_processor;
+    ThreadPool* m_pool;
+    BoundedQueue<Frame> m_queue;
+    // Only touched by whichever thread holds the drain token.
+    FrameGapTracker m_processedGaps;
+    std::vector<VideoProcessor::DetectionResult> m_results;
+    // Overlay targets. The sink, the pending preview and the shown preview
+    // may each still hold one while the next frame is drawn.
+    FramePool m_displayPool{4};
+    FrameSink m_frameSink;
+    std::thread m_workerThread;
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_previewEnabled{true};
+    // Set while a drainOnce task is queued or running. The task calls back
+    // into this worker, so stopProcessingSystem (and the destructor) wait
+    // for it to clear.
+    bool m_drainScheduled = false;
+    std::mutex m_drainMutex;
+    std::condition_variable m_drainCv;
+    // The newest frame for the preview, filled on the processing thread and
+    // swapped with m_shownPreview on the GUI thread, so once both have grown
+    // neither side allocates for the results. Posting the queued call still
+    // allocates one Qt event per previewed frame.
+    std::mutex m_previewMutex;
+    Preview m_preview;
+    bool m_previewPosted = false;
+    // Only touched on the thread the worker lives in.
+    Preview m_shownPreview;
+    std::atomic<std::uint64_t> m_droppedFrames{0};
+    std::atomic<std::uint64_t> m_processedFrames{0};
+    std::atomic<double> m_processingFps{0.0};
+    std::chrono::steady_clock::time_point m_lastFrameTime;
+
+    Histogram* m_detectLatency = &MetricsRegistry::unboundHistogram();
+    Histogram* m_sinkLatency = &MetricsRegistry::unboundHistogram();
+    Histogram* m_queuedAge = &MetricsRegistry::unboundHistogram();
+    Histogram* m_processedAge = &MetricsRegistry::unboundHistogram();
+    Counter* m_processedFramesMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_queueDropsMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_previewDropsMetric = &MetricsRegistry::unboundCounter();
+    Gauge* m_fpsMetric = &MetricsRegistry::unboundGauge();
+};
+
+}
\ No newline at end of file
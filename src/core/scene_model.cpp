@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "scene_model.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+constexpr int kFraction = 4;
+// Rows sampled per tile and pixel pairs sampled per row, whatever the
+// resolution.
+constexpr int kSampledRows = 4;
+constexpr int kPairsPerRow = 512;
+
+// The baseline moves 1/64 of the way to each learned frame.
+constexpr int kLearnShift = 6;
+constexpr int kWarmUpFrames = 25;
+
+// Thresholds in luma units, scaled like the statistics.
+constexpr std::int32_t kTextured = 1 << kFraction;
+constexpr std::int32_t kBrightnessChange = 20 << kFraction;
+constexpr std::int32_t kDark = 16 << kFraction;
+constexpr double kFlatPattern = 4 << kFraction;
+
+// Adjacent-pixel differences up to 4 luma levels are sensor noise; in the
+// 4x luma that measure() works in.
+constexpr int kNoise = 4 * 4;
+
+}
+
+const SceneModel::Observation& SceneModel::observe(const cv::Mat& frame)
+{
+    m_previousLuma = m_luma;
+    m_previousSharpness = m_sharpness;
+
+    measure(frame);
+    compare();
+    return m_observation;
+}
+
+void SceneModel::learn()
+{
+    if (m_frames == 0) {
+        m_baseLuma = m_luma;
+        m_baseSharpness = m_sharpness;
+    } else {
+        // Close to a plain average while the baseline is young.
+        int shift = 1;
+        while (shift < kLearnShift && (1 << shift) <= m_frames) {
+            ++shift;
+        }
+        for (int t = 0; t < kTileCount; ++t) {
+            m_baseLuma[t] += (m_luma[t] - m_baseLuma[t]) / (1 << shift);
+            m_baseSharpness[t] += (m_sharpness[t] - m_baseSharpness[t]) / (1 << shift);
+        }
+    }
+
+    m_frames = std::min(m_frames + 1, kWarmUpFrames + (1 << kLearnShift));
+}
+
+void SceneModel::measure(const cv::Mat& frame)
+{
+    CV_Assert(frame.depth() == CV_8U && (frame.channels() == 1 || frame.channels() == 3));
+
+    const int channels = frame.channels();
+    const int step = std::max(1, (frame.cols - 1) / kPairsPerRow);
+    // Luma scaled by 4, so grey and BGR frames share the thresholds.
+    auto luma = [channels](const uchar* pixel) {
+        return channels == 1 ? pixel[0] * 4 : pixel[0] + 2 * pixel[1] + pixel[2];
+    };
+
+    for (int ty = 0; ty < kGridRows; ++ty) {
+        const int y0 = ty * frame.rows / kGridRows;
+        const int y1 = (ty + 1) * frame.rows / kGridRows;
+
+        std::array<std::int32_t, kGridCols> lumaSum{};
+        std::array<std::int32_t, kGridCols> differenceSum{};
+        std::array<std::int32_t, kGridCols> samples{};
+
+        for (int s = 0; s < kSampledRows; ++s) {
+            const int y = std::min(frame.rows - 1, y0 + (2 * s + 1) * (y1 - y0) / (2 * kSampledRows));
+            const uchar* row = frame.ptr<uchar>(y);
+
+            for (int tx = 0; tx < kGridCols; ++tx) {
+                const int x0 = tx * frame.cols / kGridCols;
+                const int x1 = (tx + 1) * frame.cols / kGridCols;
+                for (int x = x0; x + 1 < x1; x += step) {
+                    const int left = luma(row + x * channels);
+                    const int right = luma(row + (x + 1) * channels);
+                    lumaSum[tx] += left;
+                    differenceSum[tx] += std::max(0, std::abs(right - left) - kNoise);
+                    ++samples[tx];
+                }
+            }
+        }
+
+        for (int tx = 0; tx < kGridCols; ++tx) {
+            const int t = ty * kGridCols + tx;
+            const std::int32_t count = std::max<std::int32_t>(1, samples[tx]) * 4;
+            m_luma[t] = static_cast<std::int32_t>((static_cast<std::int64_t>(lumaSum[tx]) << kFraction) / count);
+            m_sharpness[t] =
+                static_cast<std::int32_t>((static_cast<std::int64_t>(differenceSum[tx]) << kFraction) / count);
+        }
+    }
+}
+
+void SceneModel::compare()
+{
+    Observation& current = m_observation;
+    current = Observation();
+    current.identical = m_frames > 0 && m_luma == m_previousLuma && m_sharpness == m_previousSharpness;
+    current.settled = m_frames >= kWarmUpFrames;
+    if (!current.settled) {
+        return;
+    }
+
+    int textured = 0;
+    int occluded = 0;
+    std::int64_t sharpness = 0;
+    std::int64_t baseSharpness = 0;
+    std::int64_t luma = 0;
+    std::int64_t baseLuma = 0;
+    for (int t = 0; t < kTileCount; ++t) {
+        luma += m_luma[t];
+        baseLuma += m_baseLuma[t];
+
+        if (m_baseSharpness[t] < kTextured) continue;
+        ++textured;
+        sharpness += m_sharpness[t];
+        baseSharpness += m_baseSharpness[t];
+
+        const bool flat = m_sharpness[t] * 4 < m_baseSharpness[t];
+        const std::int32_t change = m_luma[t] - m_baseLuma[t];
+        if (flat && (std::abs(change) > kBrightnessChange || m_luma[t] < kDark)) {
+            ++occluded;
+        }
+    }
+
+    // Mostly blank views cannot show occlusion or blur.
+    if (textured >= kTileCount / 4 && luma > 0) {
+        current.occludedFraction = static_cast<double>(occluded) / textured;
+        // Dimmer light lowers contrast, and with it the differences, in
+        // proportion.
+        const double gain = static_cast<double>(luma) / static_cast<double>(baseLuma);
+        current.sharpnessRatio = static_cast<double>(sharpness) / (static_cast<double>(baseSharpness) * gain);
+    }
+
+    const double meanLuma = static_cast<double>(luma) / kTileCount;
+    const double meanBaseLuma = static_cast<double>(baseLuma) / kTileCount;
+    double covariance = 0.0;
+    double variance = 0.0;
+    double baseVariance = 0.0;
+    for (int t = 0; t < kTileCount; ++t) {
+        const double a = m_luma[t] - meanLuma;
+        const double b = m_baseLuma[t] - meanBaseLuma;
+        covariance += a * b;
+        variance += a * a;
+        baseVariance += b * b;
+    }
+    // An evenly lit blank view has no pattern to compare.
+    if (baseVariance > static_cast<double>(kTileCount) * kFlatPattern * kFlatPattern) {
+        current.layoutCorrelation = variance > 0.0 ? covariance / std::sqrt(variance * baseVariance) : 0.0;
+    }
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Coarse statistics of a camera's view, kept incrementally in fixed point.
+// The frame is split into a kGridCols x kGridRows grid; in each tile a few
+// rows are sampled for mean luma and for the mean difference between
+// horizontally adjacent pixels above the sensor noise, a sharpness measure. The sample count does
+// not depend on the resolution, so an update costs tens of microseconds. A
+// slow running average of both statistics is the baseline each frame is
+// compared with; it only learns from frames that look normal.
+class SceneModel {
+public:
+    static constexpr int kGridCols = 16;
+    static constexpr int kGridRows = 9;
+    static constexpr int kTileCount = kGridCols * kGridRows;
+
+    // How the last frame differs from the baseline. Fractions are of the
+    // tiles that can show the condition.
+    struct Observation {
+        // Bit-identical tile statistics to the previous frame.
+        bool identical = false;
+        // Textured tiles that turned flat and changed brightness: covered.
+        double occludedFraction = 0.0;
+        // Sharpness relative to the baseline over textured tiles, corrected
+        // for the change in overall brightness.
+        double sharpnessRatio = 1.0;
+        // Correlation of the tile brightness pattern with the baseline's.
+        // Lighting changes keep it near 1; a different view drops it.
+        double layoutCorrelation = 1.0;
+        // False until the baseline has seen enough frames.
+        bool settled = false;
+    };
+
+    // Measures frame (8-bit, 1 or 3 channels) and compares it with the
+    // baseline.
+    const Observation& observe(const cv::Mat& frame);
+    const Observation& observation() const { return m_observation; }
+    // Folds the last observed frame into the baseline. Callers skip it for
+    // frames that look tampered, so the baseline keeps the normal view.
+    void learn();
+
+    // Starts the baseline again from the next frame, e.g. once a changed
+    // view has been reported and accepted.
+    void rebaseline() { m_frames = 0; }
+
+private:
+    using Tiles = std::array<std::int32_t, kTileCount>;
+
+    void measure(const cv::Mat& frame);
+    void compare();
+
+    // In luma units << kFraction; luma is (b + 2g + r) / 4.
+    Tiles m_luma{};
+    Tiles m_sharpness{};
+    Tiles m_previousLuma{};
+    Tiles m_previousSharpness{};
+    Tiles m_baseLuma{};
+    Tiles m_baseSharpness{};
+
+    int m_frames = 0;
+    Observation m_observation;
+};
+
+}
@@ -0,0 +1,63 @@
+#include "scratch_allocator.h"
+
+namespace ArcticOwl::Core {
+
+ScratchAllocator::~ScratchAllocator()
+{
+    if (m_block) {
+        m_block->data = m_block->origdata = nullptr;
+        delete m_block;
+    }
+}
+
+cv::UMatData* ScratchAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                         cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const
+{
+    cv::MatAllocator* fallback = cv::Mat::getDefaultAllocator();
+    // User data is only wrapped, and a block still held by a header copy
+    // cannot be handed out again.
+    if (data || m_blockInUse.exchange(true, std::memory_order_acquire)) {
+        return fallback->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    // Continuous, like the default allocator.
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; --i) {
+        if (step) {
+            step[i] = total;
+        }
+        total *= static_cast<size_t>(sizes[i]);
+    }
+
+    try {
+        if (!m_block) {
+            m_block = new cv::UMatData(this);
+        }
+        if (m_block->size < total) {
+            m_block->data = m_block->origdata = nullptr;
+            m_block->size = 0;
+            m_buffer.create(1, static_cast<int>(total), CV_8UC1);
+            m_block->data = m_block->origdata = m_buffer.data;
+            m_block->size = total;
+        }
+    } catch (...) {
+        m_blockInUse.store(false, std::memory_order_release);
+        throw;
+    }
+    return m_block;
+}
+
+bool ScratchAllocator::allocate(cv::UMatData* data, cv::AccessFlag, cv::UMatUsageFlags) const
+{
+    return data != nullptr;
+}
+
+void ScratchAllocator::deallocate(cv::UMatData* data) const
+{
+    // The last header let go of the block; keep it for the next create().
+    if (data == m_block) {
+        m_blockInUse.store(false, std::memory_order_release);
+    }
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Allocator for one scratch cv::Mat whose size follows the scene: a fire
+// region, a candidate area, a blob box, a label count. OpenCV frees and
+// reallocates a Mat whenever create() asks for another size; with this
+// allocator attached, the Mat keeps one buffer and gets it back for any size
+// that fits, so it allocates only while it grows.
+// Holds a single buffer, so give each Mat its own, and declare it before the
+// Mat so it outlives it. If a header copy still holds the buffer when the
+// Mat is resized, the Mat falls back to the default allocator.
+class ScratchAllocator : public cv::MatAllocator {
+public:
+    ScratchAllocator() = default;
+    ~ScratchAllocator() override;
+
+    ScratchAllocator(const ScratchAllocator&) = delete;
+    ScratchAllocator& operator=(const ScratchAllocator&) = delete;
+
+    // Makes mat allocate through this allocator from its next create() on.
+    void attach(cv::Mat& mat) { mat.allocator = this; }
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+private:
+    // Created on first use and kept; its size is the buffer's capacity. The
+    // memory is m_buffer's, allocated by the default allocator.
+    mutable cv::UMatData* m_block = nullptr;
+    mutable cv::Mat m_buffer;
+    mutable std::atomic<bool> m_blockInUse{false};
+};
+
+}
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "thread_pool.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+thread_local const ThreadPool* t_currentPool = nullptr;
+thread_local std::size_t t_workerIndex = 0;
+
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_queues.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wakeCv.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void ThreadPool::WorkerQueue::grow()
+{
+    // Unwrap into a buffer twice the size.
+    std::vector<Task> grown(std::max<std::size_t>(16, tasks.size() * 2));
+    for (std::size_t i = 0; i < count; ++i) {
+        grown[i] = std::move(tasks[(head + i) % tasks.size()]);
+    }
+    tasks.swap(grown);
+    head = 0;
+}
+
+void ThreadPool::WorkerQueue::pushBack(Task task)
+{
+    if (count == tasks.size()) {
+        grow();
+    }
+
+    tasks[(head + count) % tasks.size()] = std::move(task);
+    ++count;
+}
+
+void ThreadPool::WorkerQueue::pushFront(Task task)
+{
+    if (count == tasks.size()) {
+        grow();
+    }
+
+    head = (head + tasks.size() - 1) % tasks.size();
+    tasks[head] = std::move(task);
+    ++count;
+}
+
+ThreadPool::Task ThreadPool::WorkerQueue::popBack()
+{
+    --count;
+    Task& slot = tasks[(head + count) % tasks.size()];
+    Task task = std::move(slot);
+    // Release the captures now rather than when the slot is reused.
+    slot = nullptr;
+    return task;
+}
+
+ThreadPool::Task ThreadPool::WorkerQueue::popFront()
+{
+    Task task = std::move(tasks[head]);
+    tasks[head] = nullptr;
+    head = (head + 1) % tasks.size();
+    --count;
+    return task;
+}
+
+void ThreadPool::submit(Task task)
+{
+    // A worker's own tasks run next; anything else waits its turn.
+    push(std::move(task), t_currentPool != this);
+}
+
+void ThreadPool::defer(Task task)
+{
+    push(std::move(task), true);
+}
+
+void ThreadPool::push(Task task, bool atFront)
+{
+    if (!task) {
+        return;
+    }
+
+    std::size_t index;
+    if (t_currentPool == this) {
+        index = t_workerIndex;
+    } else {
+        index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        if (atFront) {
+            m_queues[index]->pushFront(std::move(task));
+        } else {
+            m_queues[index]->pushBack(std::move(task));
+        }
+        // Count it before the lock is released: a thief pops, and decrements,
+        // only under this lock, so the count never drops below zero.
+        m_pendingTasks.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeCv.notify_one();
+}
+
+bool ThreadPool::runPendingTask()
+{
+    const std::size_t index = (t_currentPool == this) ? t_workerIndex : 0;
+
+    Task task;
+    if ((t_currentPool == this && popTask(index, task)) || stealTask(index, task)) {
+        runTask(task);
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(std::size_t index)
+{
+    t_currentPool = this;
+    t_workerIndex = index;
+
+    while (true) {
+        Task task;
+        if (popTask(index, task) || stealTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCv.wait(lock, [this]() {
+            return m_stopping || m_pendingTasks.load(std::memory_order_acquire) > 0;
+        });
+
+        if (m_stopping && m_pendingTasks.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    t_currentPool = nullptr;
+}
+
+bool ThreadPool::popTask(std::size_t index, Task& task)
+{
+    auto& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.count == 0) {
+        return false;
+    }
+
+    task = queue.popBack();
+    m_pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool ThreadPool::stealTask(std::size_t thief, Task& task)
+{
+    const std::size_t count = m_queues.size();
+    for (std::size_t offset = 1; offset <= count; ++offset) {
+        auto& queue = *m_queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.count == 0) {
+            continue;
+        }
+
+        task = queue.popFront();
+        m_pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::runTask(Task& task)
+{
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "Unhandled error in pool task: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected error in pool task." << std::endl;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ArcticOwl::Core {
+
+// Work-stealing pool shared by every camera. Each worker owns a deque and
+// pops at its back; idle workers steal from the front of others. Tasks a
+// worker submits go on its back and run next, so fork/join work finishes
+// first. Tasks from outside the pool, and deferred ones, go on the front and
+// run in the order they were queued. The deques are ring buffers that only grow, and a task whose captures fit
+// std::function's inline storage (e.g. a pointer and an index) is stored
+// without a heap allocation, so steady-state submit() does not allocate.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount == 0 sizes the pool to std::thread::hardware_concurrency().
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // Queues task behind everything the calling worker already has, so it runs
+    // after those and after tasks deferred before it. For tasks that requeue
+    // themselves, such as a camera's drain: they take turns with the rest
+    // instead of running again straight away. Off a pool thread it is submit().
+    void defer(Task task);
+
+    // Runs at most one queued task on the calling thread. Lets code that waits
+    // for pool work help out instead of blocking a worker.
+    bool runPendingTask();
+
+    std::size_t threadCount() const { return m_threads.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        // tasks[head], tasks[head + 1], ... (wrapping), count of them.
+        std::vector<Task> tasks;
+        std::size_t head = 0;
+        std::size_t count = 0;
+
+        void grow();
+        void pushBack(Task task);
+        void pushFront(Task task);
+        Task popBack();
+        Task popFront();
+    };
+
+    void push(Task task, bool atFront);
+    void workerLoop(std::size_t index);
+    bool popTask(std::size_t index, Task& task);
+    bool stealTask(std::size_t thief, Task& task);
+    void runTask(Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    std::atomic<std::size_t> m_pendingTasks{0};
+    std::atomic<std::size_t> m_nextQueue{0};
+    std::atomic<bool> m_stopping{false};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "tracker.h"
+
+namespace ArcticOwl::Core {
+
+namespace {
+
+// State [cx, cy, area, aspect, vx, vy, varea]; the aspect ratio is assumed
+// constant. Noise values follow SORT.
+constexpr int kStateSize = 7;
+constexpr int kMeasurementSize = 4;
+
+cv::Rect toBox(const cv::Mat& state)
+{
+    const float area = state.at<float>(2);
+    const float aspect = state.at<float>(3);
+    if (area <= 0.0f || aspect <= 0.0f) {
+        return cv::Rect();
+    }
+
+    const float width = std::sqrt(area * aspect);
+    const float height = area / width;
+    return cv::Rect(static_cast<int>(std::lround(state.at<float>(0) - width / 2.0f)),
+                    static_cast<int>(std::lround(state.at<float>(1) - height / 2.0f)),
+                    static_cast<int>(std::lround(width)), static_cast<int>(std::lround(height)));
+}
+
+double intersectionOverUnion(const cv::Rect& a, const cv::Rect& b)
+{
+    const double intersection = (a & b).area();
+    const double combined = static_cast<double>(a.area()) + b.area() - intersection;
+    return combined > 0.0 ? intersection / combined : 0.0;
+}
+
+}
+
+// Minimum-cost assignment (Hungarian method with potentials, O(n^2 m)) for a
+// rows x cols matrix in row-major order with rows <= cols. rowToCol gets the
+// column of each row.
+void Tracker::solveAssignment(const std::vector<double>& cost, int rows, int cols, bool transposed,
+                              AssignmentBuffers& buffers, std::vector<int>& rowToCol)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    auto at = [&](int row, int col) {
+        return transposed ? cost[static_cast<std::size_t>(col) * rows + row]
+                          : cost[static_cast<std::size_t>(row) * cols + col];
+    };
+
+    // One-based, with row and column 0 as the virtual start.
+    std::vector<double>& u = buffers.u;
+    std::vector<double>& v = buffers.v;
+    std::vector<double>& minv = buffers.minv;
+    std::vector<int>& owner = buffers.owner;
+    std::vector<int>& way = buffers.way;
+    std::vector<char>& used = buffers.used;
+    u.assign(rows + 1, 0.0);
+    v.assign(cols + 1, 0.0);
+    minv.resize(cols + 1);
+    owner.assign(cols + 1, 0);
+    way.assign(cols + 1, 0);
+    used.resize(cols + 1);
+
+    for (int row = 1; row <= rows; ++row) {
+        owner[0] = row;
+        int col0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+
+        do {
+            used[col0] = 1;
+            const int row0 = owner[col0];
+            double delta = inf;
+            int col1 = 0;
+            for (int col = 1; col <= cols; ++col) {
+                if (used[col]) continue;
+                const double reduced = at(row0 - 1, col - 1) - u[row0] - v[col];
+                if (reduced < minv[col]) {
+                    minv[col] = reduced;
+                    way[col] = col0;
+                }
+                if (minv[col] < delta) {
+                    delta = minv[col];
+                    col1 = col;
+                }
+            }
+            for (int col = 0; col <= cols; ++col) {
+                if (used[col]) {
+                    u[owner[col]] += delta;
+                    v[col] -= delta;
+                } else {
+                    minv[col] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (owner[col0] != 0);
+
+        do {
+            const int col1 = way[col0];
+            owner[col0] = owner[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
+
+    rowToCol.assign(rows, -1);
+    for (int col = 1; col <= cols; ++col) {
+        if (owner[col] != 0) {
+            rowToCol[owner[col] - 1] = col - 1;
+        }
+    }
+}
+
+void Tracker::update(std::vector<DetectionResult>& detections)
+{
+    advance();
+
+    const int trackCount = static_cast<int>(m_tracks.size());
+    const int detectionCount = static_cast<int>(detections.size());
+    m_trackMatched.assign(m_tracks.size(), false);
+    m_detectionMatched.assign(detections.size(), false);
+
+    if (trackCount > 0 && detectionCount > 0) {
+        // Cost 1 - IoU; pairs of different types never overlap.
+        m_cost.resize(static_cast<std::size_t>(trackCount) * detectionCount);
+        for (int t = 0; t < trackCount; ++t) {
+            for (int d = 0; d < detectionCount; ++d) {
+                const bool sameType = m_tracks[t].last.type == detections[d].type;
+                m_cost[static_cast<std::size_t>(t) * detectionCount + d] =
+                    1.0 - (sameType ? intersectionOverUnion(m_tracks[t].predicted, detections[d].boundingBox) : 0.0);
+            }
+        }
+
+        // The solver wants no more rows than columns.
+        const bool transposed = trackCount > detectionCount;
+        solveAssignment(m_cost, transposed ? detectionCount : trackCount,
+                        transposed ? trackCount : detectionCount, transposed, m_assignmentBuffers, m_assignment);
+
+        for (int row = 0; row < static_cast<int>(m_assignment.size()); ++row) {
+            const int col = m_assignment[row];
+            if (col < 0) continue;
+            const int t = transposed ? col : row;
+            const int d = transposed ? row : col;
+            if (1.0 - m_cost[static_cast<std::size_t>(t) * detectionCount + d] < m_iouThreshold) continue;
+
+            Track& track = m_tracks[t];
+            track.filter.correct(measure(detections[d].boundingBox));
+            track.last = detections[d];
+            detections[d].trackId = track.id;
+            m_trackMatched[t] = true;
+            m_detectionMatched[d] = true;
+        }
+    }
+
+    for (int t = 0; t < trackCount; ++t) {
+        m_tracks[t].missed = m_trackMatched[t] ? 0 : m_tracks[t].missed + 1;
+    }
+    // Dropped tracks are kept for startTrack, so a new track reuses their
+    // filter's matrices instead of allocating its own.
+    std::size_t kept = 0;
+    for (std::size_t t = 0; t < m_tracks.size(); ++t) {
+        if (m_tracks[t].missed > m_maxMissed) {
+            m_retiredTracks.push_back(std::move(m_tracks[t]));
+        } else {
+            if (kept != t) {
+                m_tracks[kept] = std::move(m_tracks[t]);
+            }
+            ++kept;
+        }
+    }
+    m_tracks.resize(kept);
+
+    for (int d = 0; d < detectionCount; ++d) {
+        if (!m_detectionMatched[d]) {
+            startTrack(detections[d]);
+        }
+    }
+}
+
+void Tracker::predict(std::vector<DetectionResult>& results)
+{
+    advance();
+
+    for (const auto& track : m_tracks) {
+        if (track.missed == 0 && !track.predicted.empty()) {
+            DetectionResult result = track.last;
+            result.boundingBox = track.predicted;
+            results.push_back(result);
+        }
+    }
+}
+
+void Tracker::reset()
+{
+    m_tracks.clear();
+}
+
+void Tracker::advance()
+{
+    for (auto& track : m_tracks) {
+        cv::Mat& state = track.filter.statePost;
+        // A shrinking box must not reach a negative area.
+        if (state.at<float>(2) + state.at<float>(6) <= 0.0f) {
+            state.at<float>(6) = 0.0f;
+        }
+        track.predicted = toBox(track.filter.predict());
+    }
+}
+
+void Tracker::startTrack(DetectionResult& detection)
+{
+    if (m_retiredTracks.empty()) {
+        m_tracks.emplace_back();
+    } else {
+        m_tracks.push_back(std::move(m_retiredTracks.back()));
+        m_retiredTracks.pop_back();
+    }
+
+    Track& track = m_tracks.back();
+    track.id = m_nextId++;
+    track.last = detection;
+    track.predicted = detection.boundingBox;
+    track.missed = 0;
+
+    // On a retired filter, init and the assignments below overwrite the
+    // matrices in place; they keep their sizes.
+    cv::KalmanFilter& filter = track.filter;
+    filter.init(kStateSize, kMeasurementSize, 0, CV_32F);
+    cv::setIdentity(filter.transitionMatrix);
+    for (int i = 0; i < 3; ++i) {
+        filter.transitionMatrix.at<float>(i, i + 4) = 1.0f;
+    }
+    cv::setIdentity(filter.measurementMatrix);
+
+    cv::setIdentity(filter.measurementNoiseCov);
+    filter.measurementNoiseCov.at<float>(2, 2) = 10.0f;
+    filter.measurementNoiseCov.at<float>(3, 3) = 10.0f;
+
+    // Velocities are unobserved at first, so start them very uncertain.
+    cv::setIdentity(filter.errorCovPost, cv::Scalar::all(10.0));
+    for (int i = 4; i < kStateSize; ++i) {
+        filter.errorCovPost.at<float>(i, i) = 10000.0f;
+    }
+
+    cv::setIdentity(filter.processNoiseCov);
+    for (int i = 4; i < kStateSize; ++i) {
+        filter.processNoiseCov.at<float>(i, i) = 0.01f;
+    }
+    filter.processNoiseCov.at<float>(6, 6) = 0.0001f;
+
+    filter.statePost = cv::Mat::zeros(kStateSize, 1, CV_32F);
+    measure(detection.boundingBox).copyTo(filter.statePost.rowRange(0, kMeasurementSize));
+
+    detection.trackId = track.id;
+}
+
+const cv::Mat& Tracker::measure(const cv::Rect& box)
+{
+    const float width = static_cast<float>(std::max(box.width, 1));
+    const float height = static_cast<float>(std::max(box.height, 1));
+
+    m_measurement.create(kMeasurementSize, 1, CV_32F);
+    float* measurement = m_measurement.ptr<float>();
+    measurement[0] = box.x + width / 2.0f;
+    measurement[1] = box.y + height / 2.0f;
+    measurement[2] = width * height;
+    measurement[3] = width / height;
+    return m_measurement;
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "detection_result.h"
+
+namespace ArcticOwl::Core {
+
+// SORT-style multi-object tracker. Each track is a constant-velocity Kalman
+// filter on box centre, area and aspect ratio; detections are associated to
+// the tracks' predicted boxes by IoU with an optimal (Hungarian) assignment.
+// Detections only join tracks of their own type. Gives every detection a
+// stable trackId and predicts boxes on frames where detection is skipped.
+// Every call advances the tracks by one frame. Not thread-safe.
+class Tracker {
+public:
+    // Minimum IoU between a track's predicted box and a detection to
+    // associate them.
+    void setIouThreshold(double threshold) { m_iouThreshold = threshold; }
+    // A track is dropped after this many consecutive update() calls without
+    // a matching detection.
+    void setMaxMissed(int updates) { m_maxMissed = updates; }
+
+    // Associates detections with the tracks and sets their trackId; a
+    // detection that matches no track starts a new one. Boxes are left as
+    // detected.
+    void update(std::vector<DetectionResult>& detections);
+    // Appends the predicted box of every track that matched on the last
+    // update(), carrying that detection's type, confidence and description.
+    void predict(std::vector<DetectionResult>& results);
+
+    void reset();
+    std::size_t trackCount() const { return m_tracks.size(); }
+
+private:
+    struct Track {
+        int id = 0;
+        DetectionResult last;
+        cv::KalmanFilter filter;
+        cv::Rect predicted;
+        int missed = 0;
+    };
+
+    // Hungarian method scratch, sized by the largest problem seen so far.
+    struct AssignmentBuffers {
+        std::vector<double> u;
+        std::vector<double> v;
+        std::vector<double> minv;
+        std::vector<int> owner;
+        std::vector<int> way;
+        std::vector<char> used;
+    };
+
+    static void solveAssignment(const std::vector<double>& cost, int rows, int cols, bool transposed,
+                                AssignmentBuffers& buffers, std::vector<int>& rowToCol);
+
+    void advance();
+    void startTrack(DetectionResult& detection);
+    // Fills m_measurement from box.
+    const cv::Mat& measure(const cv::Rect& box);
+
+    std::vector<Track> m_tracks;
+    // Dropped tracks, reused by startTrack.
+    std::vector<Track> m_retiredTracks;
+    int m_nextId = 1;
+    double m_iouThreshold = 0.3;
+    int m_maxMissed = 2;
+
+    // Reused between frames.
+    std::vector<double> m_cost;
+    std::vector<int> m_assignment;
+    std::vector<bool> m_trackMatched;
+    std::vector<bool> m_detectionMatched;
+    AssignmentBuffers m_assignmentBuffers;
+    cv::Mat m_measurement;
+};
+
+}
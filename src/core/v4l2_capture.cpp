@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "v4l2_capture.h"
+
+#if defined(__linux__) && defined(ARCTICOWL_WITH_V4L2)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+#define ARCTICOWL_V4L2_AVAILABLE 1
+#endif
+
+namespace ArcticOwl::Core {
+
+#ifdef ARCTICOWL_V4L2_AVAILABLE
+
+namespace {
+
+int xioctl(int fd, unsigned long request, void* arg)
+{
+    int result;
+    do {
+        result = ioctl(fd, request, arg);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+std::uint32_t fourccFromString(const std::string& name)
+{
+    if (name == "BGR3" || name == "BGR24") {
+        return V4L2_PIX_FMT_BGR24;
+    }
+    if (name == "UYVY") {
+        return V4L2_PIX_FMT_UYVY;
+    }
+    if (name == "NV12") {
+        return V4L2_PIX_FMT_NV12;
+    }
+    if (name == "MJPG" || name == "MJPEG") {
+        return V4L2_PIX_FMT_MJPEG;
+    }
+    return V4L2_PIX_FMT_YUYV;
+}
+
+int reducedDecodeFlag(int reduction)
+{
+    switch (reduction) {
+    case 2:
+        return cv::IMREAD_REDUCED_COLOR_2;
+    case 4:
+        return cv::IMREAD_REDUCED_COLOR_4;
+    case 8:
+        return cv::IMREAD_REDUCED_COLOR_8;
+    default:
+        return cv::IMREAD_COLOR;
+    }
+}
+
+std::string fourccToString(std::uint32_t fourcc)
+{
+    std::string name(4, ' ');
+    for (int i = 0; i < 4; ++i) {
+        name[i] = static_cast<char>((fourcc >> (8 * i)) & 0xFF);
+    }
+    return name;
+}
+
+}
+
+V4l2Capture::V4l2Capture() = default;
+
+V4l2Capture::~V4l2Capture()
+{
+    release();
+}
+
+bool V4l2Capture::isSupported()
+{
+    return true;
+}
+
+bool V4l2Capture::open(const std::string& device, const Options& options)
+{
+    release();
+
+    m_fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (m_fd < 0) {
+        std::cerr << "V4L2: cannot open " << device << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    v4l2_capability capability{};
+    if (xioctl(m_fd, VIDIOC_QUERYCAP, &capability) < 0
+        || !(capability.capabilities & V4L2_CAP_VIDEO_CAPTURE)
+        || !(capability.capabilities & V4L2_CAP_STREAMING)) {
+        std::cerr << "V4L2: " << device << " is not a streaming capture device." << std::endl;
+        release();
+        return false;
+    }
+
+    if (!configure(options) || !startStreaming(options.bufferCount)) {
+        release();
+        return false;
+    }
+
+    std::cerr << "V4L2: streaming " << device << " as " << fourccToString(m_pixelFormat) << " "
+              << m_width << "x" << m_height << " @ " << m_fps << " fps with " << m_buffers.size()
+              << " mmap buffers." << std::endl;
+    return true;
+}
+
+bool V4l2Capture::configure(const Options& options)
+{
+    v4l2_format format{};
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(m_fd, VIDIOC_G_FMT, &format) < 0) {
+        std::cerr << "V4L2: VIDIOC_G_FMT failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (options.width > 0 && options.height > 0) {
+        format.fmt.pix.width = static_cast<std::uint32_t>(options.width);
+        format.fmt.pix.height = static_cast<std::uint32_t>(options.height);
+    }
+    format.fmt.pix.pixelformat = fourccFromString(options.pixelFormat);
+    format.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(m_fd, VIDIOC_S_FMT, &format) < 0) {
+        std::cerr << "V4L2: VIDIOC_S_FMT failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Drivers adjust the request to the nearest mode they support.
+    m_pixelFormat = format.fmt.pix.pixelformat;
+    m_width = static_cast<int>(format.fmt.pix.width);
+    m_height = static_cast<int>(format.fmt.pix.height);
+    m_stride = static_cast<int>(format.fmt.pix.bytesperline);
+
+    switch (m_pixelFormat) {
+    case V4L2_PIX_FMT_YUYV:
+    case V4L2_PIX_FMT_UYVY:
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_MJPEG:
+    case V4L2_PIX_FMT_BGR24:
+        break;
+    default:
+        std::cerr << "V4L2: driver chose unsupported pixel format " << fourccToString(m_pixelFormat) << std::endl;
+        return false;
+    }
+    if (m_pixelFormat != fourccFromString(options.pixelFormat)) {
+        std::cerr << "V4L2: requested " << options.pixelFormat << ", driver chose "
+                  << fourccToString(m_pixelFormat) << std::endl;
+    }
+
+    m_decodeReduction = 1;
+    if (m_pixelFormat == V4L2_PIX_FMT_MJPEG && reducedDecodeFlag(options.decodeReduction) != cv::IMREAD_COLOR) {
+        m_decodeReduction = options.decodeReduction;
+    }
+
+    v4l2_streamparm params{};
+    params.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (options.fps > 0.0) {
+        params.parm.capture.timeperframe.numerator = 1000;
+        params.parm.capture.timeperframe.denominator = static_cast<std::uint32_t>(std::lround(options.fps * 1000.0));
+        if (xioctl(m_fd, VIDIOC_S_PARM, &params) < 0) {
+            std::cerr << "V4L2: cannot set frame rate, keeping the driver default." << std::endl;
+        }
+    }
+
+    m_fps = 0.0;
+    if (xioctl(m_fd, VIDIOC_G_PARM, &params) == 0 && params.parm.capture.timeperframe.numerator > 0) {
+        m_fps = static_cast<double>(params.parm.capture.timeperframe.denominator)
+                / params.parm.capture.timeperframe.numerator;
+    }
+    return true;
+}
+
+bool V4l2Capture::startStreaming(int bufferCount)
+{
+    v4l2_requestbuffers request{};
+    request.count = static_cast<std::uint32_t>(std::max(2, bufferCount));
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_REQBUFS, &request) < 0 || request.count < 2) {
+        std::cerr << "V4L2: cannot allocate mmap buffers: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    m_buffers.resize(request.count);
+    for (std::uint32_t i = 0; i < request.count; ++i) {
+        v4l2_buffer buffer{};
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        if (xioctl(m_fd, VIDIOC_QUERYBUF, &buffer) < 0) {
+            std::cerr << "V4L2: VIDIOC_QUERYBUF failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        void* start = mmap(nullptr, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buffer.m.offset);
+        if (start == MAP_FAILED) {
+            std::cerr << "V4L2: mmap failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        m_buffers[i].start = start;
+        m_buffers[i].length = buffer.length;
+
+        if (xioctl(m_fd, VIDIOC_QBUF, &buffer) < 0) {
+            std::cerr << "V4L2: VIDIOC_QBUF failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(m_fd, VIDIOC_STREAMON, &type) < 0) {
+        std::cerr << "V4L2: VIDIOC_STREAMON failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_streaming = true;
+    return true;
+}
+
+void V4l2Capture::release()
+{
+    if (m_fd < 0) {
+        return;
+    }
+
+    if (m_streaming) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(m_fd, VIDIOC_STREAMOFF, &type);
+        m_streaming = false;
+    }
+
+    for (auto& buffer : m_buffers) {
+        if (buffer.start) {
+            munmap(buffer.start, buffer.length);
+        }
+    }
+    m_buffers.clear();
+    m_current = -1;
+    m_decodeReduction = 1;
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool V4l2Capture::requeueCurrent()
+{
+    if (m_current < 0) {
+        return true;
+    }
+
+    v4l2_buffer buffer{};
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = static_cast<std::uint32_t>(m_current);
+    m_current = -1;
+    if (xioctl(m_fd, VIDIOC_QBUF, &buffer) < 0) {
+        std::cerr << "V4L2: VIDIOC_QBUF failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool V4l2Capture::grab(int timeoutMs)
+{
+    if (m_fd < 0 || !requeueCurrent()) {
+        return false;
+    }
+
+    pollfd descriptor{m_fd, POLLIN, 0};
+    int ready;
+    do {
+        ready = poll(&descriptor, 1, timeoutMs);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0 || (descriptor.revents & (POLLERR | POLLHUP))) {
+        return false;
+    }
+
+    v4l2_buffer buffer{};
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_DQBUF, &buffer) < 0) {
+        return false;
+    }
+
+    m_current = static_cast<int>(buffer.index);
+    m_bytesUsed = buffer.bytesused;
+    m_timestampMs = buffer.timestamp.tv_sec * 1000.0 + buffer.timestamp.tv_usec / 1000.0;
+
+    if (buffer.flags & V4L2_BUF_FLAG_ERROR) {
+        requeueCurrent();
+        return false;
+    }
+    return true;
+}
+
+bool V4l2Capture::retrieve(cv::Mat& frame)
+{
+    if (m_current < 0) {
+        return false;
+    }
+
+    // Wrap the mmap'd driver buffer without copying; the conversion below is
+    // the only pass over the pixels and writes straight into frame.
+    auto* data = static_cast<uchar*>(m_buffers[static_cast<std::size_t>(m_current)].start);
+    const std::size_t step = m_stride > 0 ? static_cast<std::size_t>(m_stride) : cv::Mat::AUTO_STEP;
+
+    if (m_pixelFormat != V4L2_PIX_FMT_MJPEG) {
+        frame.create(m_height, m_width, CV_8UC3);
+    }
+    switch (m_pixelFormat) {
+    case V4L2_PIX_FMT_YUYV:
+        cv::cvtColor(cv::Mat(m_height, m_width, CV_8UC2, data, step), frame, cv::COLOR_YUV2BGR_YUYV);
+        break;
+    case V4L2_PIX_FMT_UYVY:
+        cv::cvtColor(cv::Mat(m_height, m_width, CV_8UC2, data, step), frame, cv::COLOR_YUV2BGR_UYVY);
+        break;
+    case V4L2_PIX_FMT_NV12:
+        cv::cvtColor(cv::Mat(m_height * 3 / 2, m_width, CV_8UC1, data, step), frame, cv::COLOR_YUV2BGR_NV12);
+        break;
+    case V4L2_PIX_FMT_BGR24:
+        cv::Mat(m_height, m_width, CV_8UC3, data, step).copyTo(frame);
+        break;
+    case V4L2_PIX_FMT_MJPEG:
+        // imdecode reuses frame when the decoded size matches, so pooled
+        // buffers survive reduced decoding as well.
+        cv::imdecode(cv::Mat(1, static_cast<int>(m_bytesUsed), CV_8UC1, data),
+                     reducedDecodeFlag(m_decodeReduction), &frame);
+        break;
+    default:
+        return false;
+    }
+    return !frame.empty();
+}
+
+bool V4l2Capture::compressedData(const uchar*& data, std::size_t& size) const
+{
+    if (m_current < 0 || m_pixelFormat != V4L2_PIX_FMT_MJPEG) {
+        return false;
+    }
+
+    data = static_cast<const uchar*>(m_buffers[static_cast<std::size_t>(m_current)].start);
+    size = m_bytesUsed;
+    return size > 0;
+}
+
+bool V4l2Capture::deliversJpeg() const
+{
+    return m_fd >= 0 && m_pixelFormat == V4L2_PIX_FMT_MJPEG;
+}
+
+#else
+
+V4l2Capture::V4l2Capture() = default;
+
+V4l2Capture::~V4l2Capture() = default;
+
+bool V4l2Capture::isSupported()
+{
+    return false;
+}
+
+bool V4l2Capture::open(const std::string&, const Options&)
+{
+    return false;
+}
+
+void V4l2Capture::release()
+{
+}
+
+bool V4l2Capture::grab(int)
+{
+    return false;
+}
+
+bool V4l2Capture::retrieve(cv::Mat&)
+{
+    return false;
+}
+
+bool V4l2Capture::compressedData(const uchar*&, std::size_t&) const
+{
+    return false;
+}
+
+bool V4l2Capture::deliversJpeg() const
+{
+    return false;
+}
+
+bool V4l2Capture::configure(const Options&)
+{
+    return false;
+}
+
+bool V4l2Capture::startStreaming(int)
+{
+    return false;
+}
+
+bool V4l2Capture::requeueCurrent()
+{
+    return false;
+}
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// Native V4L2 streaming capture for local UVC cameras. Driver buffers are
+// mmap'd once; grab() dequeues a filled buffer without touching its pixels
+// and retrieve() converts it straight into the caller's (pooled) frame, so the
+// only pass over the image is the unavoidable colour conversion or JPEG
+// decode. Frames that are grabbed but never retrieved are handed back to the
+// driver untouched. Only available on Linux builds with ARCTICOWL_WITH_V4L2;
+// elsewhere open() always fails and callers fall back to cv::VideoCapture.
+class V4l2Capture {
+public:
+    struct Options {
+        bool enabled = false;
+        // 0 keeps the driver's current width/height/frame rate.
+        int width = 0;
+        int height = 0;
+        double fps = 0.0;
+        // FourCC: YUYV, UYVY, NV12, MJPG or BGR3.
+        std::string pixelFormat = "YUYV";
+        int bufferCount = 4;
+        // MJPG only: decode at 1/2, 1/4 or 1/8 of the stream size through
+        // libjpeg's DCT scaling, which skips most of the IDCT work.
+        int decodeReduction = 1;
+    };
+
+    V4l2Capture();
+    ~V4l2Capture();
+
+    V4l2Capture(const V4l2Capture&) = delete;
+    V4l2Capture& operator=(const V4l2Capture&) = delete;
+
+    static bool isSupported();
+
+    bool open(const std::string& device, const Options& options);
+    void release();
+    bool isOpened() const { return m_fd >= 0; }
+
+    // Waits up to timeoutMs for the next filled buffer.
+    bool grab(int timeoutMs);
+    // Converts the grabbed buffer into frame, reusing frame's allocation when
+    // its size and type already match (CV_8UC3 BGR).
+    bool retrieve(cv::Mat& frame);
+    // Points at the grabbed buffer's JPEG bitstream when streaming MJPG; the
+    // bytes stay valid until the next grab() or release().
+    bool compressedData(const uchar*& data, std::size_t& size) const;
+    bool deliversJpeg() const;
+
+    // Driver timestamp of the grabbed buffer, in milliseconds.
+    double timestampMs() const { return m_timestampMs; }
+    double fps() const { return m_fps; }
+    cv::Size frameSize() const { return cv::Size(m_width, m_height); }
+    // Size of retrieved frames relative to frameSize().
+    double decodeScale() const { return 1.0 / m_decodeReduction; }
+
+private:
+    struct Buffer {
+        void* start = nullptr;
+        std::size_t length = 0;
+    };
+
+    bool configure(const Options& options);
+    bool startStreaming(int bufferCount);
+    bool requeueCurrent();
+
+    int m_fd = -1;
+    std::vector<Buffer> m_buffers;
+    int m_current = -1;
+    std::uint32_t m_bytesUsed = 0;
+    std::uint32_t m_pixelFormat = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    double m_fps = 0.0;
+    double m_timestampMs = 0.0;
+    int m_decodeReduction = 1;
+    bool m_streaming = false;
+};
+
+}
\ No newline at end of file
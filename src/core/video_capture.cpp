@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <mutex>
 #include <thread>
@@ -7,6 +10,36 @@
 
 namespace ArcticOwl::Core {
 
+namespace {
+
+constexpr auto kReadFailureDelay = std::chrono::milliseconds(100);
+// Timestamp jumps beyond this (seeks, stalls, wrapped clocks) re-anchor
+// pacing instead of sleeping or racing to catch up.
+constexpr auto kMaxPacingDrift = std::chrono::seconds(1);
+
+// A few failed grabs are tolerated before the source is considered lost.
+constexpr int kFailuresBeforeReconnect = 3;
+constexpr auto kReconnectBaseDelay = std::chrono::milliseconds(500);
+constexpr auto kReconnectMaxDelay = std::chrono::milliseconds(30000);
+// Bounds how long open() and grab() may block on a dead network stream.
+constexpr int kStreamTimeoutMs = 5000;
+
+// rtsp://, rtmp://, http:// and any other scheme except file://.
+bool isNetworkUrl(const std::string& source)
+{
+    const std::size_t end = source.find("://");
+    if (end == std::string::npos || end == 0) {
+        return false;
+    }
+
+    std::string scheme = source.substr(0, end);
+    std::transform(scheme.begin(), scheme.end(), scheme.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return scheme != "file";
+}
+
+}
+
 VideoCapture::VideoCapture(QObject* parent, int camera_id, const std::string& rtsp_url, const std::string& rtmp_url)
     : QObject(parent)
     , m_cameraId(camera_id)
@@ -23,24 +56,15 @@ VideoCapture::~VideoCapture()
 
 bool VideoCapture::startVideoCaptureSystem() {
     try {
-        if (!m_rtspUrl.empty()) {
-            m_capture.open(m_rtspUrl);
-        } else if (!m_rtmpUrl.empty()) {
-            m_capture.open(m_rtmpUrl);
-        } else {
-            m_capture.open(m_cameraId);
-        }
-
-        if (!m_capture.isOpened()){
+        if (!openSource()) {
             std::cerr << "Failed to open capture source. cameraId=" << m_cameraId
                        << ", rtspUrl=" << m_rtspUrl << ", rtmpUrl="
                        << m_rtmpUrl << std::endl;
             return false;
         }
 
-        m_capture.set(cv::CAP_PROP_BUFFERSIZE, 1);
-
         m_isRunning = true;
+        setConnected(true);
         m_captureThread = std::thread(&VideoCapture::captureLoop, this);
 
         return true;
@@ -58,15 +82,18 @@ bool VideoCapture::startVideoCaptureSystem() {
 
 bool VideoCapture::stopVideoCaptureSystem() {
     try {
-        m_isRunning = false;
+        {
+            std::lock_guard<std::mutex> lock(m_stopMutex);
+            m_isRunning = false;
+        }
+        m_stopCv.notify_all();
 
         if (m_captureThread.joinable()) {
             m_captureThread.join();
         }
 
-        if (m_capture.isOpened()) {
-            m_capture.release();
-        }
+        releaseSource();
+        setConnected(false);
 
         return true;
     } catch (const cv::Exception& e) {
@@ -80,13 +107,43 @@ bool VideoCapture::stopVideoCaptureSystem() {
     return false;
 }
 
+void VideoCapture::setMetricsLabels(const std::string& labels)
+{
+    auto& registry = MetricsRegistry::instance();
+    const auto withReason = [&labels](const char* reason) {
+        const std::string reasonLabel = MetricsRegistry::label("reason", reason);
+        return labels.empty() ? reasonLabel : labels + "," + reasonLabel;
+    };
+
+    m_grabLatency = &registry.histogram("arcticowl_capture_grab_seconds",
+                                        "Time spent in grab() waiting for and demuxing the next frame.", labels);
+    m_readLatency = &registry.histogram("arcticowl_capture_retrieve_seconds",
+                                        "Time spent decoding a grabbed frame into a pooled buffer.", labels);
+    m_capturedFramesMetric = &registry.counter("arcticowl_captured_frames_total",
+                                               "Frames decoded from the source.", labels);
+    m_poolDropsMetric = &registry.counter("arcticowl_dropped_frames_total",
+                                          "Frames dropped before reaching the next stage.",
+                                          withReason("pool_exhausted"));
+    m_busyDropsMetric = &registry.counter("arcticowl_dropped_frames_total",
+                                          "Frames dropped before reaching the next stage.",
+                                          withReason("downstream_busy"));
+    m_rateLimitedMetric = &registry.counter("arcticowl_capture_rate_limited_frames_total",
+                                            "Frames grabbed but not decoded to honour the target analysis fps.",
+                                            labels);
+    m_reconnectMetric = &registry.counter("arcticowl_capture_reconnects_total",
+                                          "Times a lost source was reopened.", labels);
+    m_reconnectFailureMetric = &registry.counter("arcticowl_capture_reconnect_failures_total",
+                                                 "Failed attempts to reopen a lost source.", labels);
+    m_passthroughMetric = &registry.counter("arcticowl_capture_passthrough_frames_total",
+                                            "Compressed frames forwarded without decoding.", labels);
+    m_connectedMetric = &registry.gauge("arcticowl_capture_connected",
+                                        "1 while the source delivers frames, 0 while reconnecting.", labels);
+}
+
 cv::Mat VideoCapture::getCurrentFrame() {
     try {
         std::lock_guard<std::mutex> lock(m_frameMutex);
-        if (m_currentFrame.empty()) {
-            return cv::Mat();
-        }
-        return m_currentFrame.clone();
+        return m_currentFrame;
     } catch (const std::exception& e) {
         std::cerr << "Failed to get frame: " << e.what() << std::endl;
         return cv::Mat();
@@ -98,7 +155,7 @@ cv::Mat VideoCapture::getCurrentFrame() {
 
 bool VideoCapture::isOpened() const {
     try {
-        return m_capture.isOpened();
+        return (m_v4l2 && m_v4l2->isOpened()) || m_capture.isOpened();
     } catch (const cv::Exception& e) {
         std::cerr << "OpenCV error: " << e.what() << std::endl;
         return false;
@@ -112,48 +169,354 @@ bool VideoCapture::isOpened() const {
 }
 
 void VideoCapture::captureLoop() {
-    const auto interval = std::chrono::milliseconds(m_frameIntervalMs);
+    int consecutiveFailures = 0;
 
     while (m_isRunning) {
-        const auto loopStart = std::chrono::steady_clock::now();
-
         try {
-            cv::Mat frame;
-            bool frame_read = m_capture.read(frame);
+            bool grabbed = false;
+            {
+                StageTimer timer(m_grabLatency);
+                grabbed = grabFrame();
+            }
 
-            if (frame_read && !frame.empty()) {
-                std::lock_guard<std::mutex> lock(m_frameMutex);
-                m_currentFrame = frame.clone();
-
-                if (m_pendingFrames.load(std::memory_order_relaxed) < 2) {
-                    m_pendingFrames.fetch_add(1, std::memory_order_relaxed);
-                    QMetaObject::invokeMethod(this, [this, frame]() {
-                            emit frameReady(frame);
-                            m_pendingFrames.fetch_sub(1, std::memory_order_relaxed);
-                    }, Qt::QueuedConnection);
+            if (!grabbed) {
+                if (m_isFileSource) {
+                    std::cerr << "End of video file reached." << std::endl;
+                    setConnected(false);
+                    break;
                 }
-            } else if (!frame_read) {
+
                 std::cerr << "Failed to read video frame." << std::endl;
-                std::this_thread::sleep_for(interval);
+                if (++consecutiveFailures < kFailuresBeforeReconnect) {
+                    waitForStop(kReadFailureDelay);
+                } else {
+                    consecutiveFailures = 0;
+                    reconnect();
+                }
+                continue;
+            }
+            consecutiveFailures = 0;
+
+            Frame grabbed;
+            grabbed.cameraIndex = m_cameraIndex;
+            grabbed.sequence = ++m_sequence;
+            grabbed.captureTime = std::chrono::steady_clock::now();
+
+            const double frameMs = nextFrameTimestamp();
+            grabbed.ptsMs = frameMs;
+            paceTo(frameMs);
+            forwardCompressed(grabbed);
+
+            // Every skip below happens before retrieve(), so skipped frames are
+            // never decoded or colour converted.
+            if (!dueForDelivery(frameMs)) {
+                m_rateLimitedMetric->inc();
+                continue;
+            }
+
+            if (m_readyProbe && !m_readyProbe()) {
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                m_busyDropsMetric->inc();
+                continue;
+            }
+
+            Frame frame = grabbed;
+            frame.image = m_framePool.acquire();
+            if (frame.image.empty() && m_framePool.isConfigured()) {
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                m_poolDropsMetric->inc();
+                continue;
+            }
+
+            const uchar* pooledData = frame.image.data;
+            bool retrieved = false;
+            {
+                StageTimer timer(m_readLatency);
+                retrieved = retrieveFrame(frame.image);
+            }
+
+            if (!retrieved || frame.empty()) {
+                std::cerr << "Failed to decode video frame." << std::endl;
+                continue;
             }
+
+            m_capturedFramesMetric->inc();
+
+            if (frame.image.data != pooledData) {
+                // First frame, or the source changed geometry and retrieve()
+                // allocated a new buffer: size the pool after it.
+                m_framePool.configure(frame.image.size(), frame.image.type());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_frameMutex);
+                m_currentFrame = frame.image;
+            }
+
+            frame.droppedBefore = m_emitGaps.observe(frame.sequence);
+
+            emit frameReady(frame);
         } catch (const cv::Exception& e) {
             std::cerr << "OpenCV error: " << e.what() << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::this_thread::sleep_for(kReadFailureDelay);
         } catch (const std::exception& e) {
             std::cerr << "Error: " << e.what() << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::this_thread::sleep_for(kReadFailureDelay);
         } catch (...) {
             std::cerr << "Unexpected error." << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::this_thread::sleep_for(kReadFailureDelay);
+        }
+    }
+}
+
+bool VideoCapture::openSource()
+{
+    try {
+        // Network streams get open/read timeouts so a dead peer ends up as a
+        // failed grab() (and a reconnect) instead of blocking forever.
+        const std::vector<int> streamParams = {
+            cv::CAP_PROP_OPEN_TIMEOUT_MSEC, kStreamTimeoutMs,
+            cv::CAP_PROP_READ_TIMEOUT_MSEC, kStreamTimeoutMs
+        };
+
+        if (!m_rtspUrl.empty()) {
+            m_capture.open(m_rtspUrl, cv::CAP_ANY, streamParams);
+        } else if (!m_rtmpUrl.empty()) {
+            m_capture.open(m_rtmpUrl, cv::CAP_ANY, streamParams);
+        } else if (m_v4l2Options.enabled && m_cameraId >= 0 && V4l2Capture::isSupported()) {
+            if (!m_v4l2) {
+                m_v4l2 = std::make_unique<V4l2Capture>();
+            }
+            if (!m_v4l2->open("/dev/video" + std::to_string(m_cameraId), m_v4l2Options)) {
+                std::cerr << "V4L2 backend unavailable for camera " << m_cameraId
+                          << ", falling back to OpenCV capture." << std::endl;
+                m_capture.open(m_cameraId);
+            }
+        } else {
+            if (m_v4l2Options.enabled && !V4l2Capture::isSupported()) {
+                std::cerr << "V4L2 backend not compiled in, using OpenCV capture." << std::endl;
+            }
+            m_capture.open(m_cameraId);
+        }
+
+        if (!isOpened()) {
+            return false;
+        }
+
+        if (m_capture.isOpened()) {
+            m_capture.set(cv::CAP_PROP_BUFFERSIZE, 1);
+        }
+        // Some FFmpeg network streams report a frame count as well, so only a
+        // local path can be a file; streams and devices are reconnected.
+        const std::string& url = !m_rtspUrl.empty() ? m_rtspUrl : m_rtmpUrl;
+        m_isFileSource = !url.empty() && !isNetworkUrl(url) && sourceProperty(cv::CAP_PROP_FRAME_COUNT) > 0;
+        const bool v4l2Open = m_v4l2 && m_v4l2->isOpened();
+        m_decodeScale.store(v4l2Open ? m_v4l2->decodeScale() : 1.0, std::memory_order_relaxed);
+        m_passthroughActive.store(m_compressedSink && v4l2Open && m_v4l2->deliversJpeg(),
+                                  std::memory_order_relaxed);
+        resetPacing();
+        return true;
+    } catch (const cv::Exception& e) {
+        std::cerr << "OpenCV error while opening source: " << e.what() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error while opening source: " << e.what() << std::endl;
+    }
+
+    return false;
+}
+
+void VideoCapture::releaseSource()
+{
+    if (m_v4l2) {
+        m_v4l2->release();
+    }
+    if (m_capture.isOpened()) {
+        m_capture.release();
+    }
+}
+
+bool VideoCapture::grabFrame()
+{
+    if (m_v4l2 && m_v4l2->isOpened()) {
+        return m_v4l2->grab(kStreamTimeoutMs);
+    }
+    return m_capture.grab();
+}
+
+bool VideoCapture::retrieveFrame(cv::Mat& frame)
+{
+    if (m_v4l2 && m_v4l2->isOpened()) {
+        return m_v4l2->retrieve(frame);
+    }
+    return m_capture.retrieve(frame);
+}
+
+void VideoCapture::forwardCompressed(const Frame& grabbed)
+{
+    if (!m_passthroughActive.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uchar* data = nullptr;
+    std::size_t size = 0;
+    if (m_v4l2->compressedData(data, size)) {
+        Frame encoded = grabbed;
+        encoded.image = cv::Mat(1, static_cast<int>(size), CV_8UC1, const_cast<uchar*>(data));
+        m_compressedSink(encoded);
+        m_passthroughMetric->inc();
+    }
+}
+
+double VideoCapture::sourceProperty(int property) const
+{
+    if (m_v4l2 && m_v4l2->isOpened()) {
+        // Driver timestamps are monotonic; a live device has no frame count.
+        switch (property) {
+        case cv::CAP_PROP_POS_MSEC:
+            return m_v4l2->timestampMs();
+        case cv::CAP_PROP_FPS:
+            return m_v4l2->fps();
+        default:
+            return 0.0;
         }
+    }
+    return m_capture.get(property);
+}
+
+bool VideoCapture::reconnect()
+{
+    setConnected(false);
+    std::cerr << "Capture source lost, reconnecting. cameraId=" << m_cameraId
+              << ", rtspUrl=" << m_rtspUrl << ", rtmpUrl=" << m_rtmpUrl << std::endl;
+
+    // Exponential backoff with equal jitter, so many cameras behind the same
+    // failed switch or NVR do not retry in lockstep.
+    auto delay = kReconnectBaseDelay;
+    for (int attempt = 1; m_isRunning; ++attempt) {
+        releaseSource();
+
+        if (openSource()) {
+            m_reconnects.fetch_add(1, std::memory_order_relaxed);
+            m_reconnectMetric->inc();
+            setConnected(true);
+            std::cerr << "Capture source reconnected after " << attempt << " attempt(s)." << std::endl;
+            return true;
+        }
+
+        m_reconnectFailureMetric->inc();
+
+        std::uniform_int_distribution<long long> jitter(delay.count() / 2, delay.count());
+        if (waitForStop(std::chrono::milliseconds(jitter(m_backoffRandom)))) {
+            break;
+        }
+        delay = std::min(delay * 2, kReconnectMaxDelay);
+    }
+
+    return false;
+}
 
-        const auto loopEnd = std::chrono::steady_clock::now();
-        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(loopEnd - loopStart);
+bool VideoCapture::waitForStop(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    return m_stopCv.wait_for(lock, timeout, [this]() { return !m_isRunning; });
+}
+
+void VideoCapture::setConnected(bool connected)
+{
+    if (m_connected.exchange(connected) != connected) {
+        m_connectedMetric->set(connected ? 1.0 : 0.0);
+        emit connectionChanged(connected);
+    }
+}
+
+void VideoCapture::resetPacing()
+{
+    m_pacing = Pacing();
+    m_loopStart = std::chrono::steady_clock::now();
+
+    const double nominalFps = sourceProperty(cv::CAP_PROP_FPS);
+    if (nominalFps > 0.0 && nominalFps < 1000.0) {
+        m_pacing.frameIntervalMs = 1000.0 / nominalFps;
+        m_sourceFps = nominalFps;
+    }
 
-        if (elapsed < interval) {
-            std::this_thread::sleep_for(interval - elapsed);
+    // Live cameras and streams block in grab() until the next frame exists, so
+    // sleeping would only add latency. Local files can be read faster than
+    // real time and are paced to their timestamps.
+    m_pacing.paceToTimestamps = m_isFileSource;
+}
+
+double VideoCapture::nextFrameTimestamp()
+{
+    Pacing& pacing = m_pacing;
+
+    double frameMs = sourceProperty(cv::CAP_PROP_POS_MSEC);
+    if (!std::isfinite(frameMs) || frameMs <= pacing.lastFrameMs) {
+        // No usable presentation timestamp: step at the nominal rate, or fall
+        // back to the wall clock when the source does not report one either.
+        if (pacing.frameIntervalMs > 0.0 && pacing.lastFrameMs >= 0.0) {
+            frameMs = pacing.lastFrameMs + pacing.frameIntervalMs;
+        } else {
+            frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_loopStart).count();
         }
     }
+
+    if (pacing.lastFrameMs >= 0.0) {
+        const double delta = frameMs - pacing.lastFrameMs;
+        if (delta > 0.0 && delta < 1000.0) {
+            pacing.frameIntervalMs = pacing.frameIntervalMs > 0.0 ? pacing.frameIntervalMs * 0.9 + delta * 0.1 : delta;
+            m_sourceFps.store(1000.0 / pacing.frameIntervalMs, std::memory_order_relaxed);
+        }
+    }
+
+    pacing.lastFrameMs = frameMs;
+    return frameMs;
+}
+
+void VideoCapture::paceTo(double frameMs)
+{
+    Pacing& pacing = m_pacing;
+    if (!pacing.paceToTimestamps) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto target = pacing.anchorWall + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double, std::milli>(frameMs - pacing.anchorMs));
+
+    if (!pacing.anchored || target - now > kMaxPacingDrift || now - target > kMaxPacingDrift) {
+        pacing.anchored = true;
+        pacing.anchorWall = now;
+        pacing.anchorMs = frameMs;
+        return;
+    }
+
+    if (target > now) {
+        std::this_thread::sleep_until(target);
+    }
+}
+
+bool VideoCapture::dueForDelivery(double frameMs)
+{
+    const double targetFps = m_targetFps.load(std::memory_order_relaxed);
+    if (targetFps <= 0.0) {
+        return true;
+    }
+
+    Pacing& pacing = m_pacing;
+    const double deliveryIntervalMs = 1000.0 / targetFps;
+
+    // Accept frames up to half a source interval early so timestamp jitter
+    // does not halve the delivered rate.
+    if (frameMs + pacing.frameIntervalMs * 0.5 < pacing.nextDeliveryMs) {
+        return false;
+    }
+
+    // Stay phase-locked to the cadence, but restart it after a gap.
+    pacing.nextDeliveryMs = frameMs - pacing.nextDeliveryMs < deliveryIntervalMs
+        ? pacing.nextDeliveryMs + deliveryIntervalMs
+        : frameMs + deliveryIntervalMs;
+    return true;
 }
 
 }
\ No newline at end of file
@@ -2,11 +2,23 @@
 
 #include <QObject>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
 #include <string>
 #include <thread>
+#include <memory>
 #include <mutex>
 #include <opencv2/opencv.hpp>
 
+#include "frame.h"
+#include "frame_pool.h"
+#include "metrics.h"
+#include "v4l2_capture.h"
+
 namespace ArcticOwl::Core {
 
 class VideoCapture : public QObject
@@ -14,33 +26,149 @@ class VideoCapture : public QObject
     Q_OBJECT
 
 public:
+    // Returns false while the consumer still has an unprocessed frame queued.
+    using ReadyProbe = std::function<bool()>;
+    // Receives every grabbed frame of a JPEG source with image wrapping the
+    // bitstream (1 x size, CV_8UC1). The bytes are only valid for the duration
+    // of the call.
+    using CompressedSink = std::function<void(const Frame& encoded)>;
+
     explicit VideoCapture(QObject* parent = nullptr, int camera_id = -1, const std::string& rtsp_url = "", const std::string& rtmp_url = "");
     ~VideoCapture();
 
     bool startVideoCaptureSystem();
     bool stopVideoCaptureSystem();
 
+    // Shares the pooled buffer of the latest frame instead of copying it. The
+    // buffer is read-only for everyone once emitted; overlays are drawn into
+    // a separate copy by ProcessingWorker, so this never carries them.
     cv::Mat getCurrentFrame();
 
     bool isOpened() const;
 
+    // False while a lost source is being reopened. Reconnecting happens inside
+    // the capture thread, so consumers and their state are left untouched.
+    bool isConnected() const { return m_connected.load(std::memory_order_relaxed); }
+    std::uint64_t reconnectCount() const { return m_reconnects.load(std::memory_order_relaxed); }
+
+    // Frames grabbed but never decoded because downstream was behind or every
+    // pooled buffer was still in use.
+    std::uint64_t droppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+    // Caps how often frames are decoded and emitted, using the source's frame
+    // timestamps. 0 (the default) passes every frame through.
+    void setTargetFps(double fps) { m_targetFps.store(fps > 0.0 ? fps : 0.0, std::memory_order_relaxed); }
+    double targetFps() const { return m_targetFps.load(std::memory_order_relaxed); }
+
+    // Frame rate measured from source timestamps.
+    double sourceFps() const { return m_sourceFps.load(std::memory_order_relaxed); }
+
+    // Consulted before decoding each frame. Set before start.
+    void setReadyProbe(ReadyProbe probe) { m_readyProbe = std::move(probe); }
+
+    // Forwards MJPEG frames untouched, before any rate limiting or decode
+    // decision, so streaming never waits for analysis. Only sources that
+    // deliver JPEG (V4L2 with pixel_format=MJPG) feed the sink. Set before start.
+    void setCompressedSink(CompressedSink sink) { m_compressedSink = std::move(sink); }
+
+    // True while the open source feeds the compressed sink.
+    bool isPassthroughActive() const { return m_passthroughActive.load(std::memory_order_relaxed); }
+
+    // Size of emitted frames relative to the source (below 1 when MJPEG is
+    // decoded at reduced size).
+    double decodeScale() const { return m_decodeScale.load(std::memory_order_relaxed); }
+
+    // Opens local cameras through the native V4L2 backend instead of OpenCV
+    // when options.enabled is set. Falls back to OpenCV when the backend is
+    // not compiled in or the device rejects the format. Set before start.
+    void setV4l2Options(const V4l2Capture::Options& options) { m_v4l2Options = options; }
+
+    // Registers the capture metrics under a label set such as camera="0";
+    // until then they are recorded but not exported. Only call while the
+    // capture is stopped.
+    void setMetricsLabels(const std::string& labels);
+
+    // Stamped into Frame::cameraIndex. Set before start.
+    void setCameraIndex(int index) { m_cameraIndex = index; }
+
 private:
+    // Capture-thread state for timestamp-driven pacing and decimation. Times
+    // are in source milliseconds.
+    struct Pacing {
+        bool paceToTimestamps = false;
+        bool anchored = false;
+        std::chrono::steady_clock::time_point anchorWall;
+        double anchorMs = 0.0;
+        double lastFrameMs = -1.0;
+        double frameIntervalMs = 0.0;
+        double nextDeliveryMs = 0.0;
+    };
+
     void captureLoop();
+    bool openSource();
+    void releaseSource();
+    // Route to the V4L2 backend when it is open, otherwise to cv::VideoCapture.
+    bool grabFrame();
+    bool retrieveFrame(cv::Mat& frame);
+    void forwardCompressed(const Frame& grabbed);
+    double sourceProperty(int property) const;
+    bool reconnect();
+    bool waitForStop(std::chrono::milliseconds timeout);
+    void setConnected(bool connected);
+    void resetPacing();
+    double nextFrameTimestamp();
+    void paceTo(double frameMs);
+    bool dueForDelivery(double frameMs);
 
 signals:
-    void frameReady(const cv::Mat& frame);
+    // Emitted on the capture thread. Slow consumers should hand the frame to
+    // a ProcessingWorker rather than doing work inside the slot.
+    void frameReady(const ArcticOwl::Core::Frame& frame);
+
+    // Emitted on the capture thread when the source is lost and when it comes back.
+    void connectionChanged(bool connected);
 
 private:
     int m_cameraId;
+    int m_cameraIndex = -1;
     std::string m_rtspUrl;
     std::string m_rtmpUrl;
     cv::VideoCapture m_capture;
+    V4l2Capture::Options m_v4l2Options;
+    std::unique_ptr<V4l2Capture> m_v4l2;
     std::thread m_captureThread;
     std::atomic<bool> m_isRunning;
-    std::atomic<int> m_pendingFrames{0};
+    std::atomic<bool> m_connected{false};
+    std::atomic<std::uint64_t> m_droppedFrames{0};
+    std::atomic<std::uint64_t> m_reconnects{0};
+    bool m_isFileSource = false;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCv;
+    std::mt19937 m_backoffRandom{std::random_device{}()};
+    FramePool m_framePool;
     cv::Mat m_currentFrame;
+    std::uint64_t m_sequence = 0;
+    FrameGapTracker m_emitGaps;
     std::mutex m_frameMutex;
-    const int m_frameIntervalMs = 33;
+    ReadyProbe m_readyProbe;
+    CompressedSink m_compressedSink;
+    std::atomic<bool> m_passthroughActive{false};
+    std::atomic<double> m_decodeScale{1.0};
+    std::atomic<double> m_targetFps{0.0};
+    std::atomic<double> m_sourceFps{0.0};
+    Pacing m_pacing;
+    std::chrono::steady_clock::time_point m_loopStart;
+
+    Histogram* m_grabLatency = &MetricsRegistry::unboundHistogram();
+    Histogram* m_readLatency = &MetricsRegistry::unboundHistogram();
+    Counter* m_capturedFramesMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_poolDropsMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_busyDropsMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_rateLimitedMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_reconnectMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_reconnectFailureMetric = &MetricsRegistry::unboundCounter();
+    Counter* m_passthroughMetric = &MetricsRegistry::unboundCounter();
+    Gauge* m_connectedMetric = &MetricsRegistry::unboundGauge();
 };
 
 }
\ No newline at end of file
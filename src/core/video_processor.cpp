@@ -1,52 +1,73 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 #include "video_processor.h"
+#include "thread_pool.h"
 
 namespace ArcticOwl::Core {
 
 VideoProcessor::VideoProcessor()
-    : m_intrusionDetection(true)
-    , m_fireDetection(true)
-    , m_motionDetection(true)
-    , m_frameCount(0)
 {
-    m_backgroundSubtractorMOG2 = cv::createBackgroundSubtractorMOG2(500, 16, true);
-    m_backgroundSubtractorKNN = cv::createBackgroundSubtractorKNN(500, 400, true);
+    DetectorRegistry& registry = DetectorRegistry::instance();
+    for (const auto& name : registry.names()) {
+        addDetector(registry.create(name));
+    }
+
+    m_backgroundModel = BackgroundModel::create(m_activeEngine);
+    m_morphKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    m_context.setForegroundModel([this](const cv::Mat& frame, cv::Mat& mask) {
+        computeForegroundMask(frame, mask);
+    });
 }
 
 VideoProcessor::~VideoProcessor()
 {
-    m_backgroundSubtractorMOG2.release();
-    m_backgroundSubtractorKNN.release();
+    waitForPoolTasks();
 }
 
 std::vector<VideoProcessor::DetectionResult> VideoProcessor::processFrame(const cv::Mat& frame)
 {
     std::vector<DetectionResult> results;
+    processFrame(frame, results);
+    return results;
+}
+
+void VideoProcessor::processFrame(const cv::Mat& frame, std::vector<DetectionResult>& results)
+{
+    results.clear();
 
     if (frame.empty()) {
-        return results;
+        return;
     }
 
     try {
-        updateAccumulatedBackground(frame);
-
-        if (m_motionDetection) {
-            auto motionResults = detectMotion(frame);
-            results.insert(results.end(), motionResults.begin(), motionResults.end());
+        if (m_framesUntilDetection > 0) {
+            --m_framesUntilDetection;
+            predictTrackedResults(frame.size(), results);
+            return;
         }
 
-        if (m_intrusionDetection) {
-            auto intrusionResults = detectIntrusion(frame);
-            results.insert(results.end(), intrusionResults.begin(), intrusionResults.end());
-        }
+        AnalysisContext& context = beginAnalysis(frame);
+        const cv::Mat& analysisFrame = context.frame();
 
-        if (m_fireDetection) {
-            auto fireResults = detectFire(frame);
-            results.insert(results.end(), fireResults.begin(), fireResults.end());
+        runDetectors(context, results);
+
+        if (analysisFrame.data != frame.data) {
+            mapToFullResolution(results,
+                                static_cast<double>(frame.cols) / analysisFrame.cols,
+                                static_cast<double>(frame.rows) / analysisFrame.rows,
+                                frame.size());
         }
+
+        m_tracker.update(results);
+        m_framesUntilDetection = m_detectionStride.load() - 1;
     } catch (const cv::Exception& e) {
         std::cerr << "OpenCV error while processing frame: " << e.what() << std::endl;
     } catch (const std::exception& e) {
@@ -55,243 +76,400 @@ std::vector<VideoProcessor::DetectionResult> VideoProcessor::processFrame(const
         std::cerr << "Unexpected error while processing frame" << std::endl;
     }
 
-    return results;
+    m_context.releaseFrame();
 }
 
-std::vector<VideoProcessor::DetectionResult> VideoProcessor::detectMotion(const cv::Mat& frame)
+void VideoProcessor::addDetector(std::unique_ptr<Detector> detector)
 {
-    std::vector<DetectionResult> results;
-
-    if (frame.empty()) {
-        return results;
+    if (detector) {
+        m_detectors.push_back(std::move(detector));
     }
 
-    try {
-        cv::Mat fgMaskMOG2, fgMaskKNN;
-        m_backgroundSubtractorMOG2->apply(frame, fgMaskMOG2);
-        m_backgroundSubtractorKNN->apply(frame, fgMaskKNN);
-
-        cv::Mat combinedMask;
-        cv::bitwise_and(fgMaskMOG2, fgMaskKNN, combinedMask);
+    if (m_detectors.size() > m_groupSlots) {
+        // Late tasks of the last frame may still read the flags.
+        waitForPoolTasks();
+        m_groupSlots = m_detectors.size();
+        m_groupClaimed = std::make_unique<std::atomic<bool>[]>(m_groupSlots);
+        for (std::size_t group = 0; group < m_groupSlots; ++group) {
+            m_groupClaimed[group].store(true, std::memory_order_relaxed);
+        }
+    }
+}
 
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-        cv::morphologyEx(combinedMask, combinedMask, cv::MORPH_OPEN, kernel);
-        cv::morphologyEx(combinedMask, combinedMask, cv::MORPH_CLOSE, kernel);
+bool VideoProcessor::setDetectorEnabled(const std::string& name, bool enabled)
+{
+    Detector* target = detector(name);
+    if (!target) {
+        return false;
+    }
 
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(combinedMask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    target->setEnabled(enabled);
+    return true;
+}
 
-        for (const auto& contour : contours) {
-            double area = cv::contourArea(contour);
-            if (area < 500) continue;
+bool VideoProcessor::setDetectorSchedule(const std::string& name, const Detector::Schedule& schedule)
+{
+    Detector* target = detector(name);
+    if (!target) {
+        return false;
+    }
 
-            cv::Rect boundingBox = cv::boundingRect(contour);
-            double confidence = std::min(1.0, area / 10000.0);
+    target->setSchedule(schedule);
+    return true;
+}
 
-            DetectionResult result;
-            result.type = DetectionResult::MOTION;
-            result.boundingBox = boundingBox;
-            result.confidence = static_cast<float>(confidence);
-            result.description = "motion";
-            results.push_back(result);
+Detector* VideoProcessor::detector(const std::string& name) const
+{
+    for (const auto& detector : m_detectors) {
+        if (detector->name() == name) {
+            return detector.get();
         }
-    } catch (const cv::Exception& e) {
-        std::cerr << "OpenCV error during motion detection: " << e.what() << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during motion detection: " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "Unexpected error during motion detection" << std::endl;
     }
+    return nullptr;
+}
 
-    return results;
+void VideoProcessor::setZones(std::vector<Zone> zones)
+{
+    std::lock_guard<std::mutex> lock(m_zonesMutex);
+    m_pendingZones = std::move(zones);
+    m_zonesChanged = true;
 }
 
-std::vector<VideoProcessor::DetectionResult> VideoProcessor::detectIntrusion(const cv::Mat& frame)
+void VideoProcessor::setDetectionStride(int stride)
 {
-    std::vector<DetectionResult> results;
+    m_detectionStride = std::max(1, stride);
+}
 
-    if (frame.empty()) {
-        return results;
+void VideoProcessor::setAnalysisScale(double scale)
+{
+    m_analysisScale = (scale > 0.0 && scale < 1.0) ? scale : 1.0;
+}
+
+void VideoProcessor::setMorphologyScale(double scale)
+{
+    m_morphologyScale = (scale > 0.0 && scale < 1.0) ? scale : 1.0;
+}
+
+void VideoProcessor::setInputScale(double scale)
+{
+    m_inputScale = (scale > 0.0 && scale < 1.0) ? scale : 1.0;
+}
+
+const char* VideoProcessor::typeName(DetectionResult::Type type)
+{
+    switch (type) {
+    case DetectionResult::INTRUSION:
+        return "intrusion";
+    case DetectionResult::FIRE:
+        return "fire";
+    case DetectionResult::EQUIPMENT_FAILURE:
+        return "equipment_failure";
+    case DetectionResult::MOTION:
+        return "motion";
+    case DetectionResult::OBJECT:
+        return "object";
     }
+    return "unknown";
+}
 
-    try {
-        cv::Rect intrusionArea(frame.cols / 4, frame.rows / 4, frame.cols / 2, frame.rows / 2);
-
-        auto motionResults = detectMotion(frame);
-
-        for (const auto& motion : motionResults) {
-            if ((motion.boundingBox & intrusionArea).area() > 0) {
-                DetectionResult result;
-                result.type = DetectionResult::INTRUSION;
-                result.boundingBox = motion.boundingBox;
-                result.confidence = motion.confidence; // 使用运动检测的置信度
-                result.description = "intrusion";
-                results.push_back(result);
-            }
-        }
-    } catch (const cv::Exception& e) {
-        std::cerr << "OpenCV error during intrusion detection: " << e.what() << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during intrusion detection: " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "Unexpected error during intrusion detection" << std::endl;
+AnalysisContext& VideoProcessor::beginAnalysis(const cv::Mat& frame)
+{
+    prepareAnalysisPlane(frame);
+    if (m_zonesChanged.exchange(false)) {
+        std::lock_guard<std::mutex> lock(m_zonesMutex);
+        m_context.zones().setZones(std::move(m_pendingZones));
+        m_pendingZones.clear();
     }
+    m_context.reset(m_analysisFrame.empty() ? frame : m_analysisFrame, m_areaScale, m_morphKernel,
+                    m_morphologyScale.load());
+    return m_context;
+}
 
-    return results;
+void VideoProcessor::prepareAnalysisPlane(const cv::Mat& frame)
+{
+    // Frames already decoded below source resolution only need the remaining
+    // reduction; everything below stays relative to the source.
+    const double inputScale = m_inputScale.load();
+    const double scale = std::min(1.0, m_analysisScale.load() / inputScale);
+    const cv::Size analysisSize(std::max(1, static_cast<int>(std::lround(frame.cols * scale))),
+                                std::max(1, static_cast<int>(std::lround(frame.rows * scale))));
+
+    if (analysisSize == frame.size()) {
+        m_analysisFrame.release();
+        m_areaScale = inputScale * inputScale;
+    } else {
+        // INTER_AREA averages whole source pixels, which also suppresses the
+        // sensor noise that would otherwise show up in the foreground masks.
+        cv::resize(frame, m_analysisFrame, analysisSize, 0, 0, cv::INTER_AREA);
+        m_areaScale = (static_cast<double>(analysisSize.width) / frame.cols)
+                    * (static_cast<double>(analysisSize.height) / frame.rows)
+                    * inputScale * inputScale;
+    }
+
+    // The 5x5 cleanup kernel is sized for full resolution; shrink it with the
+    // plane so small objects are not erased, but keep at least 3x3.
+    const double sourceScale = scale * inputScale;
+    if (m_kernelScale != sourceScale) {
+        const int size = std::max(3, static_cast<int>(std::lround(5.0 * sourceScale)) | 1);
+        m_morphKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(size, size));
+        m_kernelScale = sourceScale;
+    }
 }
 
-std::vector<VideoProcessor::DetectionResult> VideoProcessor::detectFire(const cv::Mat& frame)
+void VideoProcessor::mapToFullResolution(std::vector<DetectionResult>& results, double scaleX, double scaleY,
+                                         cv::Size frameSize)
 {
-    std::vector<DetectionResult> results;
+    const cv::Rect frameRect(0, 0, frameSize.width, frameSize.height);
+
+    for (auto& result : results) {
+        const cv::Rect& box = result.boundingBox;
+        const int x0 = static_cast<int>(std::floor(box.x * scaleX));
+        const int y0 = static_cast<int>(std::floor(box.y * scaleY));
+        const int x1 = static_cast<int>(std::ceil((box.x + box.width) * scaleX));
+        const int y1 = static_cast<int>(std::ceil((box.y + box.height) * scaleY));
+        result.boundingBox = cv::Rect(x0, y0, x1 - x0, y1 - y0) & frameRect;
+    }
+}
+
+void VideoProcessor::predictTrackedResults(cv::Size frameSize, std::vector<DetectionResult>& results)
+{
+    const cv::Rect frameRect(0, 0, frameSize.width, frameSize.height);
 
+    m_tracker.predict(results);
+    for (auto& result : results) {
+        result.boundingBox &= frameRect;
+    }
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [](const DetectionResult& result) { return result.boundingBox.empty(); }),
+                  results.end());
+}
+
+void VideoProcessor::annotateFrame(cv::Mat& frame, const std::vector<DetectionResult>& results)
+{
     if (frame.empty()) {
-        return results;
+        return;
     }
 
-    try {
-        cv::Mat hsv, yuv;
-        cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
-        cv::cvtColor(frame, yuv, cv::COLOR_BGR2YUV);
-
-        cv::Mat color_mask_fire_hsv_lower, color_mask_fire_hsv_upper, color_mask_fire_hsv;
-        cv::inRange(hsv, cv::Scalar(0, 100, 100), cv::Scalar(15, 255, 255), color_mask_fire_hsv_lower);
-        cv::inRange(hsv, cv::Scalar(160, 100, 100), cv::Scalar(180, 255, 255), color_mask_fire_hsv_upper);
-        cv::bitwise_or(color_mask_fire_hsv_lower, color_mask_fire_hsv_upper, color_mask_fire_hsv);
-
-        std::vector<cv::Mat> yuv_channels;
-        cv::split(yuv, yuv_channels);
-        cv::Mat y_channel = yuv_channels[0];
-        cv::Mat u_channel = yuv_channels[1];
-
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-        cv::morphologyEx(color_mask_fire_hsv, color_mask_fire_hsv, cv::MORPH_OPEN, kernel);
-        cv::morphologyEx(color_mask_fire_hsv, color_mask_fire_hsv, cv::MORPH_CLOSE, kernel);
-
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(color_mask_fire_hsv, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-        for (const auto& contour : contours) {
-            double area = cv::contourArea(contour);
-            if (area < 500) continue;
-            cv::Rect boundingBox = cv::boundingRect(contour);
-
-            boundingBox.x = std::max(0, boundingBox.x);
-            boundingBox.y = std::max(0, boundingBox.y);
-            boundingBox.width = std::min(frame.cols - boundingBox.x, boundingBox.width);
-            boundingBox.height = std::min(frame.rows - boundingBox.y, boundingBox.height);
-
-            if (boundingBox.width > 0 && boundingBox.height > 0) {
-                cv::Mat region = frame(boundingBox);
-
-                double texture = calculateTextureFeature(region);
-
-                double shape = calculateShapeFeature(contour);
-
-                double colorConfidence = std::min(1.0, area / 5000.0);
-                double textureConfidence = texture;
-                double shapeConfidence = shape;
-                double confidence = (colorConfidence + textureConfidence + shapeConfidence) / 3.0;
-
-                if (confidence > 0.4) {
-                    DetectionResult result;
-                    result.type = DetectionResult::FIRE;
-                    result.boundingBox = boundingBox;
-                    result.confidence = static_cast<float>(std::min(1.0, confidence));
-                    result.description = "fire";
-                    results.push_back(result);
-                }
-            }
+    // Formatted on the stack; putText wants a std::string, so one per thread
+    // keeps its capacity between calls.
+    thread_local std::string label;
+
+    for (const auto& r : results) {
+        cv::Scalar color(0, 255, 0);
+        if (r.type == DetectionResult::FIRE) color = cv::Scalar(0, 0, 255);
+        if (r.type == DetectionResult::INTRUSION) color = cv::Scalar(255, 0, 0);
+        if (r.type == DetectionResult::EQUIPMENT_FAILURE) color = cv::Scalar(0, 255, 255);
+        if (r.type == DetectionResult::OBJECT) color = cv::Scalar(255, 0, 255);
+        cv::rectangle(frame, r.boundingBox, color, 2);
+        char text[128];
+        if (r.trackId >= 0) {
+            std::snprintf(text, sizeof(text), "%s (%f) #%d", r.description, r.confidence, r.trackId);
+        } else {
+            std::snprintf(text, sizeof(text), "%s (%f)", r.description, r.confidence);
         }
-    } catch (const cv::Exception& e) {
-        std::cerr << "OpenCV error during fire detection: " << e.what() << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during fire detection: " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "Unexpected error during fire detection" << std::endl;
+        label.assign(text);
+        cv::Point textOrg(r.boundingBox.x, std::max(0, r.boundingBox.y - 5));
+        cv::putText(frame, label, textOrg, cv::FONT_HERSHEY_SIMPLEX, 0.5, color, 1);
     }
+}
 
-    return results;
+void VideoProcessor::computeForegroundMask(const cv::Mat& frame, cv::Mat& mask)
+{
+    const BackgroundModel::Engine engine = m_backgroundEngine.load();
+    if (engine != m_activeEngine) {
+        m_backgroundModel = BackgroundModel::create(engine);
+        m_activeEngine = engine;
+    }
+
+    m_backgroundModel->apply(frame, mask);
 }
 
-double VideoProcessor::calculateTextureFeature(const cv::Mat& image)
+void VideoProcessor::assignDetectorRegions(AnalysisContext& context)
 {
-    if (image.empty()) {
-        return 0.0;
+    const cv::Rect wholeFrame(0, 0, context.frame().cols, context.frame().rows);
+
+    for (const auto& detector : m_detectors) {
+        detector->m_regions.clear();
+        if (!detector->isEnabled()) {
+            continue;
+        }
+
+        const Detector::Schedule schedule = detector->schedule();
+        if (!schedule.foregroundGated) {
+            detector->m_regions.push_back(wholeFrame);
+            continue;
+        }
+
+        if (schedule.refreshInterval > 0 && --detector->m_framesUntilFullScan <= 0) {
+            detector->m_regions.push_back(wholeFrame);
+            detector->m_framesUntilFullScan = schedule.refreshInterval;
+            continue;
+        }
+
+        // Computed here, before the groups fan out, so a gated detector does
+        // not have to share a group with the foreground readers.
+        const auto& dirty = context.dirtyRegions();
+        detector->m_regions.assign(dirty.begin(), dirty.end());
     }
+}
 
-    try {
-        cv::Mat gray;
-        if (image.channels() == 3) {
-            cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
-        } else {
-            gray = image;
+void VideoProcessor::planDetectorGroups()
+{
+    m_groupCount = 0;
+
+    for (std::size_t index = 0; index < m_detectors.size(); ++index) {
+        const Detector& detector = *m_detectors[index];
+        if (detector.regions().empty()) {
+            continue;
         }
 
-        // 计算梯度
-        cv::Mat grad_x, grad_y;
-        cv::Sobel(gray, grad_x, CV_64F, 1, 0, 3);
-        cv::Sobel(gray, grad_y, CV_64F, 0, 1, 3);
+        // Join every group that reads one of this detector's planes; a
+        // detector that bridges two groups merges them.
+        const Detector::Inputs inputs = detector.inputs();
+        std::size_t target = m_groupCount;
+        for (std::size_t group = 0; group < m_groupCount;) {
+            if ((m_groupInputs[group] & inputs) == 0) {
+                ++group;
+                continue;
+            }
 
-        cv::Mat magnitude;
-        cv::magnitude(grad_x, grad_y, magnitude);
+            if (target == m_groupCount) {
+                target = group;
+                ++group;
+                continue;
+            }
 
-        double meanGradient = cv::mean(magnitude)[0];
+            auto& members = m_detectorGroups[target];
+            members.insert(members.end(), m_detectorGroups[group].begin(), m_detectorGroups[group].end());
+            m_groupInputs[target] |= m_groupInputs[group];
+            // Move the merged group behind the used ones, keeping the order
+            // of the rest and the capacity of its list.
+            const auto first = static_cast<std::ptrdiff_t>(group);
+            const auto last = static_cast<std::ptrdiff_t>(m_groupCount);
+            std::rotate(m_detectorGroups.begin() + first, m_detectorGroups.begin() + first + 1,
+                        m_detectorGroups.begin() + last);
+            std::rotate(m_groupInputs.begin() + first, m_groupInputs.begin() + first + 1,
+                        m_groupInputs.begin() + last);
+            --m_groupCount;
+        }
 
-        return std::max(0.0, std::min(1.0, meanGradient / 255.0));
-    } catch (...) {
-        return 0.0;
+        if (target == m_groupCount) {
+            if (m_groupCount == m_detectorGroups.size()) {
+                m_detectorGroups.emplace_back();
+                m_groupInputs.push_back(0);
+            }
+            m_detectorGroups[target].clear();
+            m_groupInputs[target] = 0;
+            ++m_groupCount;
+        }
+        m_detectorGroups[target].push_back(index);
+        m_groupInputs[target] |= inputs;
     }
 }
 
-double VideoProcessor::calculateShapeFeature(const std::vector<cv::Point>& contour)
+void VideoProcessor::runDetectors(AnalysisContext& context, std::vector<DetectionResult>& results)
 {
-    if (contour.empty()) {
-        return 0.0;
+    assignDetectorRegions(context);
+    planDetectorGroups();
+
+    m_detectorResults.resize(m_detectors.size());
+    for (auto& output : m_detectorResults) {
+        output.clear();
     }
 
-    try {
-        double area = cv::contourArea(contour);
-        double perimeter = cv::arcLength(contour, true);
+    const std::size_t groupCount = m_groupCount;
+    if (!m_pool || groupCount < 2) {
+        for (std::size_t group = 0; group < groupCount; ++group) {
+            runDetectorGroup(group, context);
+        }
+    } else {
+        // Offer every group but the first to the pool, then work through the
+        // list here as well. Whatever the pool has not started by then runs
+        // on this thread, so a saturated pool (or one whose worker is calling
+        // us) never leaves the frame waiting on a queued task.
+        {
+            std::lock_guard<std::mutex> lock(m_groupsMutex);
+            m_groupsFinished = 0;
+        }
+        // Everything the groups read is in place; releasing the flags
+        // publishes it to whichever thread claims them.
+        for (std::size_t group = 0; group < groupCount; ++group) {
+            m_groupClaimed[group].store(false, std::memory_order_release);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_poolTasksMutex);
+            m_poolTasks += groupCount - 1;
+        }
+        // Pointer and index fit std::function's inline storage.
+        for (std::size_t group = 1; group < groupCount; ++group) {
+            m_pool->submit([this, group]() { runPoolTask(group); });
+        }
 
-        if (perimeter == 0) return 0;
+        for (std::size_t group = 0; group < groupCount; ++group) {
+            claimDetectorGroup(group);
+        }
 
-        double circularity = (4 * CV_PI * area) / (perimeter * perimeter);
+        std::unique_lock<std::mutex> lock(m_groupsMutex);
+        m_groupsCv.wait(lock, [this, groupCount]() { return m_groupsFinished == groupCount; });
+    }
 
-        return std::max(0.0, std::min(1.0, circularity / 0.8));
-    } catch (...) {
-        return 0.0;
+    // Merge in registration order so the output does not depend on timing.
+    for (auto& output : m_detectorResults) {
+        results.insert(results.end(), output.begin(), output.end());
     }
 }
 
-void VideoProcessor::updateAccumulatedBackground(const cv::Mat& frame) {
-    if (frame.empty()) {
-        return;
+void VideoProcessor::runDetectorGroup(std::size_t group, AnalysisContext& context)
+{
+    for (std::size_t index : m_detectorGroups[group]) {
+        Detector& detector = *m_detectors[index];
+        try {
+            detector.detect(context, m_detectorResults[index]);
+        } catch (const cv::Exception& e) {
+            std::cerr << "OpenCV error in " << detector.name() << " detector: " << e.what() << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error in " << detector.name() << " detector: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Unexpected error in " << detector.name() << " detector" << std::endl;
+        }
     }
+}
 
-    try {
-        if (m_accumulatedBackground.empty()) {
-            m_accumulatedBackground = cv::Mat::zeros(frame.size(), CV_32FC3);
-            m_frameCount = 0;
-        }
+bool VideoProcessor::claimDetectorGroup(std::size_t group)
+{
+    if (m_groupClaimed[group].exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
 
-        cv::Mat floatFrame;
-        frame.convertTo(floatFrame, CV_32FC3);
+    runDetectorGroup(group, m_context);
 
-        cv::accumulate(floatFrame, m_accumulatedBackground);
-        m_frameCount++;
+    {
+        std::lock_guard<std::mutex> lock(m_groupsMutex);
+        ++m_groupsFinished;
+    }
+    m_groupsCv.notify_one();
+    return true;
+}
 
-        if (m_frameCount >= 100) {
-            m_accumulatedBackground /= static_cast<float>(m_frameCount);
-            m_accumulatedBackground.convertTo(m_accumulatedBackground, CV_8UC3);
-            m_frameCount = 0;
-        }
-    } catch (const cv::Exception& e) {
-        std::cerr << "OpenCV error while updating background: " << e.what() << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error while updating background: " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "Unexpected error while updating background" << std::endl;
+void VideoProcessor::runPoolTask(std::size_t group)
+{
+    claimDetectorGroup(group);
+    finishPoolTask();
+}
+
+void VideoProcessor::finishPoolTask()
+{
+    // Notify under the lock: once it is released the destructor may run.
+    std::lock_guard<std::mutex> lock(m_poolTasksMutex);
+    if (--m_poolTasks == 0) {
+        m_poolTasksCv.notify_all();
     }
 }
 
+void VideoProcessor::waitForPoolTasks()
+{
+    std::unique_lock<std::mutex> lock(m_poolTasksMutex);
+    m_poolTasksCv.wait(lock, [this]() { return m_poolTasks == 0; });
+}
+
 }
\ No newline at end of file
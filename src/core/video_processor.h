@@ -1,52 +1,180 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <opencv2/opencv.hpp>
 
+#include "analysis_context.h"
+#include "background_model.h"
+#include "detection_result.h"
+#include "detector.h"
+#include "tracker.h"
+#include "zone_map.h"
+
 namespace ArcticOwl::Core {
 
+struct VideoProcessorBenchAccess;
+class ThreadPool;
+
 class VideoProcessor {
 public:
-    struct DetectionResult {
-        enum Type {
-            INTRUSION,
-            FIRE,
-            EQUIPMENT_FAILURE,
-            MOTION
-        };
-
-        Type type;
-        cv::Rect boundingBox;
-        float confidence;
-        std::string description;
-    };
+    using DetectionResult = Core::DetectionResult;
 
+    // Instantiates every detector in DetectorRegistry.
     VideoProcessor();
     ~VideoProcessor();
 
+    // Results carry track ids. On frames skipped by the detection stride they
+    // are the tracks' predicted boxes.
     std::vector<DetectionResult> processFrame(const cv::Mat& frame);
-    void setIntrusionDetection(bool enabled) { m_intrusionDetection = enabled; }
-    void setFireDetection(bool enabled) { m_fireDetection = enabled; }
-    void setMotionDetection(bool enabled) { m_motionDetection = enabled; }
+    // Same, into results (cleared first). Scratch planes, detector outputs
+    // and tracker state keep their buffers, so once they have grown to the
+    // scene the processor's own code allocates nothing per frame; pass the
+    // same vector every frame to keep that true for the results as well.
+    void processFrame(const cv::Mat& frame, std::vector<DetectionResult>& results);
+    void setIntrusionDetection(bool enabled) { setDetectorEnabled("intrusion", enabled); }
+    void setFireDetection(bool enabled) { setDetectorEnabled("fire", enabled); }
+    void setMotionDetection(bool enabled) { setDetectorEnabled("motion", enabled); }
+    void setEquipmentFailureDetection(bool enabled) { setDetectorEnabled("equipment", enabled); }
+
+    // Adds a detector after the registered ones. Not thread-safe with
+    // processFrame; call it before the first frame.
+    void addDetector(std::unique_ptr<Detector> detector);
+    // Returns false if no detector has that name.
+    bool setDetectorEnabled(const std::string& name, bool enabled);
+    // Returns false if no detector has that name. Takes effect on the next
+    // frame.
+    bool setDetectorSchedule(const std::string& name, const Detector::Schedule& schedule);
+    Detector* detector(const std::string& name) const;
+
+    // Detectors that share no context plane run concurrently on pool; the
+    // calling thread takes part and processFrame returns once all are done.
+    // Without a pool (the default) they run in order on the calling thread.
+    void setThreadPool(ThreadPool* pool) { m_pool = pool; }
+
+    // Engine behind the foreground mask used by motion and intrusion. A change
+    // takes effect on the next frame and starts the new model from scratch.
+    void setBackgroundEngine(BackgroundModel::Engine engine) { m_backgroundEngine = engine; }
+    BackgroundModel::Engine backgroundEngine() const { return m_backgroundEngine.load(); }
+
+    // Polygon zones for intrusion detection and foreground exclusion (see
+    // ZoneMap). Safe to call while frames are processed; takes effect on the
+    // next frame. Without include zones the central quarter is guarded.
+    void setZones(std::vector<Zone> zones);
+
+    // Full detection runs on every stride-th frame (1 = every frame). Frames in
+    // between only advance the tracker and return its predicted boxes, so
+    // detector CPU drops by about the stride; the background models also
+    // learn only from detection frames. Takes effect after the next
+    // detection frame.
+    void setDetectionStride(int stride);
+    int detectionStride() const { return m_detectionStride.load(); }
+
+    // Detectors run on a copy downscaled by this factor (0 < scale <= 1);
+    // results are reported in full-resolution coordinates. Area thresholds are
+    // expressed in full-resolution pixels, so they hold at any scale.
+    void setAnalysisScale(double scale);
+    double analysisScale() const { return m_analysisScale.load(); }
+
+    // Mask cleanup (opening and closing) runs on a copy of each mask reduced
+    // by this factor (0 < scale <= 1) and is scaled back before labelling.
+    // Cheaper at 0.5, at the cost of blockier blob outlines.
+    void setMorphologyScale(double scale);
+    double morphologyScale() const { return m_morphologyScale.load(); }
+
+    // Fraction of the source resolution that incoming frames were decoded at
+    // (e.g. 0.5 for JPEG sources decoded at half size). The analysis scale and
+    // area thresholds stay relative to the source; boxes are reported in the
+    // coordinates of the frame passed to processFrame.
+    void setInputScale(double scale);
+
+    static const char* typeName(DetectionResult::Type type);
+
+    static void annotateFrame(cv::Mat& frame, const std::vector<DetectionResult>& results);
 
 private:
-    std::vector<DetectionResult> detectMotion(const cv::Mat& frame);
-    std::vector<DetectionResult> detectIntrusion(const cv::Mat& frame);
-    std::vector<DetectionResult> detectFire(const cv::Mat& frame);
-    double calculateTextureFeature(const cv::Mat& image);
-    double calculateShapeFeature(const std::vector<cv::Point>& contour);
-    void updateAccumulatedBackground(const cv::Mat& frame);
-
-    bool m_intrusionDetection;
-    bool m_fireDetection;
-    bool m_motionDetection;
-
-    cv::Ptr<cv::BackgroundSubtractor> m_backgroundSubtractorMOG2;
-    cv::Ptr<cv::BackgroundSubtractor> m_backgroundSubtractorKNN;
-
-    cv::Mat m_accumulatedBackground;
-    int m_frameCount;
+    // Lets bench/ time the individual detector stages.
+    friend struct VideoProcessorBenchAccess;
+
+    // Prepares the analysis plane for frame and resets the shared context.
+    AnalysisContext& beginAnalysis(const cv::Mat& frame);
+    void computeForegroundMask(const cv::Mat& frame, cv::Mat& mask);
+
+    // Picks the regions each enabled detector examines on this frame.
+    void assignDetectorRegions(AnalysisContext& context);
+    // Splits the detectors with work on this frame into groups with no
+    // input in common.
+    void planDetectorGroups();
+    void runDetectors(AnalysisContext& context, std::vector<DetectionResult>& results);
+    void runDetectorGroup(std::size_t group, AnalysisContext& context);
+    bool claimDetectorGroup(std::size_t group);
+    void runPoolTask(std::size_t group);
+    void finishPoolTask();
+    void waitForPoolTasks();
+
+    // Tracker predictions for a frame without detection, clipped to it.
+    void predictTrackedResults(cv::Size frameSize, std::vector<DetectionResult>& results);
+
+    void prepareAnalysisPlane(const cv::Mat& frame);
+    static void mapToFullResolution(std::vector<DetectionResult>& results, double scaleX, double scaleY,
+                                    cv::Size frameSize);
+
+    std::vector<std::unique_ptr<Detector>> m_detectors;
+    // Per-frame schedule: indices into m_detectors, and each detector's output.
+    // Only the first m_groupCount groups are used; the rest are kept so their
+    // member lists need not be allocated again.
+    std::vector<std::vector<std::size_t>> m_detectorGroups;
+    std::vector<Detector::Inputs> m_groupInputs;
+    std::size_t m_groupCount = 0;
+    std::vector<std::vector<DetectionResult>> m_detectorResults;
+    ThreadPool* m_pool = nullptr;
+    // One claim flag per possible group (there are at most as many groups as
+    // detectors), all set between frames. A pool task carries only this
+    // processor and a group index, so submitting it does not allocate. A
+    // task that starts after its frame is done finds its group claimed, or
+    // claims and runs the same group of the frame in progress.
+    std::unique_ptr<std::atomic<bool>[]> m_groupClaimed;
+    std::size_t m_groupSlots = 0;
+    std::mutex m_groupsMutex;
+    std::condition_variable m_groupsCv;
+    std::size_t m_groupsFinished = 0;
+    // Submitted pool tasks that have not returned yet. They may outlive the
+    // frame that queued them, so the destructor waits for them, and so does
+    // addDetector before it replaces m_groupClaimed.
+    std::mutex m_poolTasksMutex;
+    std::condition_variable m_poolTasksCv;
+    std::size_t m_poolTasks = 0;
+
+    std::atomic<BackgroundModel::Engine> m_backgroundEngine{BackgroundModel::MOG2_KNN};
+    std::unique_ptr<BackgroundModel> m_backgroundModel;
+    BackgroundModel::Engine m_activeEngine = BackgroundModel::MOG2_KNN;
+
+    std::atomic<double> m_analysisScale{1.0};
+    std::atomic<double> m_inputScale{1.0};
+    std::atomic<double> m_morphologyScale{1.0};
+    cv::Mat m_analysisFrame;
+    // Square of the scale in effect for the current frame.
+    double m_areaScale = 1.0;
+    double m_kernelScale = 1.0;
+    cv::Mat m_morphKernel;
+
+    AnalysisContext m_context;
+
+    // Associates results across frames and fills in skipped frames; works in
+    // the coordinates of the frames passed to processFrame.
+    Tracker m_tracker;
+    std::atomic<int> m_detectionStride{1};
+    int m_framesUntilDetection = 0;
+
+    // Zones waiting to be handed to m_context on the next frame.
+    std::mutex m_zonesMutex;
+    std::vector<Zone> m_pendingZones;
+    std::atomic<bool> m_zonesChanged{false};
 
 };
 
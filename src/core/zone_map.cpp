@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "zone_map.h"
+
+namespace ArcticOwl::Core {
+
+bool Zone::parsePolygon(const std::string& text, std::vector<cv::Point2f>& polygon)
+{
+    std::vector<cv::Point2f> vertices;
+    std::istringstream stream(text);
+    std::string vertex;
+    while (stream >> vertex) {
+        std::istringstream coordinates(vertex);
+        float x = 0.0f;
+        float y = 0.0f;
+        char comma = 0;
+        if (!(coordinates >> x >> comma >> y) || comma != ',' || !coordinates.eof()
+            || x < 0.0f || x > 1.0f || y < 0.0f || y > 1.0f) {
+            return false;
+        }
+        vertices.emplace_back(x, y);
+    }
+
+    if (vertices.size() < 3) {
+        return false;
+    }
+    polygon = std::move(vertices);
+    return true;
+}
+
+bool Zone::parseKind(const std::string& text, Kind& kind)
+{
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "include") {
+        kind = INCLUDE;
+        return true;
+    }
+    if (lower == "exclude") {
+        kind = EXCLUDE;
+        return true;
+    }
+    return false;
+}
+
+void ZoneMap::setZones(std::vector<Zone> zones)
+{
+    m_zones = std::move(zones);
+    m_compiledSize = cv::Size();
+}
+
+void ZoneMap::compile(cv::Size size)
+{
+    if (size == m_compiledSize) {
+        return;
+    }
+
+    m_includeMask.create(size, CV_8UC1);
+    m_includeMask.setTo(cv::Scalar::all(0));
+    m_excludeMask.release();
+
+    bool hasInclude = false;
+    for (const Zone& zone : m_zones) {
+        if (zone.kind == Zone::INCLUDE) {
+            fillZone(m_includeMask, zone, size);
+            hasInclude = true;
+        } else {
+            if (m_excludeMask.empty()) {
+                m_excludeMask = cv::Mat::zeros(size, CV_8UC1);
+            }
+            fillZone(m_excludeMask, zone, size);
+        }
+    }
+
+    if (!hasInclude) {
+        // The guard area intrusion detection always used.
+        m_includeMask(cv::Rect(size.width / 4, size.height / 4, size.width / 2, size.height / 2))
+            .setTo(cv::Scalar::all(1));
+    }
+
+    // Pixels are 0 or 1, so sums stay within CV_32S at any frame size.
+    cv::integral(m_includeMask, m_includeIntegral, CV_32S);
+    m_compiledSize = size;
+}
+
+int ZoneMap::includedArea(const cv::Rect& box) const
+{
+    const cv::Rect clipped = box & cv::Rect(0, 0, m_compiledSize.width, m_compiledSize.height);
+    if (clipped.empty()) {
+        return 0;
+    }
+
+    const int x0 = clipped.x;
+    const int y0 = clipped.y;
+    const int x1 = clipped.x + clipped.width;
+    const int y1 = clipped.y + clipped.height;
+    return m_includeIntegral.at<int>(y1, x1) - m_includeIntegral.at<int>(y0, x1)
+         - m_includeIntegral.at<int>(y1, x0) + m_includeIntegral.at<int>(y0, x0);
+}
+
+void ZoneMap::fillZone(cv::Mat& mask, const Zone& zone, cv::Size size)
+{
+    std::vector<cv::Point> vertices;
+    vertices.reserve(zone.polygon.size());
+    for (const auto& vertex : zone.polygon) {
+        vertices.emplace_back(static_cast<int>(std::lround(vertex.x * size.width)),
+                              static_cast<int>(std::lround(vertex.y * size.height)));
+    }
+
+    // Include masks hold 1 per pixel for the integral image; any nonzero
+    // value works for the exclude mask.
+    cv::fillPoly(mask, std::vector<std::vector<cv::Point>>{vertices}, cv::Scalar::all(1));
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace ArcticOwl::Core {
+
+// A polygon of the camera view. Vertices are fractions of the frame width and
+// height, so a zone holds at any resolution and analysis scale.
+struct Zone {
+    enum Kind {
+        // Foreground overlapping an include zone is reported as intrusion.
+        INCLUDE,
+        // Foreground inside an exclude zone is dropped before any detector
+        // sees it.
+        EXCLUDE
+    };
+
+    std::string name;
+    Kind kind = INCLUDE;
+    std::vector<cv::Point2f> polygon;
+
+    // Parses "x,y x,y x,y ..." (at least three vertices, each in [0, 1]).
+    // Returns false and leaves polygon untouched otherwise.
+    static bool parsePolygon(const std::string& text, std::vector<cv::Point2f>& polygon);
+    // "include" or "exclude", case-insensitively.
+    static bool parseKind(const std::string& text, Kind& kind);
+};
+
+// Zones rasterised for one plane size. All include zones share one mask and
+// one integral image, and all exclude zones one mask, so hit tests and the
+// exclusion cost the same however many zones there are. Without include
+// zones the central quarter of the frame is guarded. Not thread-safe.
+class ZoneMap {
+public:
+    void setZones(std::vector<Zone> zones);
+    const std::vector<Zone>& zones() const { return m_zones; }
+
+    // Rasterises the zones for planes of size; does nothing if they already
+    // are.
+    void compile(cv::Size size);
+
+    // Pixels of box inside an include zone, from four integral-image reads.
+    int includedArea(const cv::Rect& box) const;
+
+    // Nonzero where an exclude zone lies; empty when there is none.
+    const cv::Mat& excludeMask() const { return m_excludeMask; }
+
+private:
+    static void fillZone(cv::Mat& mask, const Zone& zone, cv::Size size);
+
+    std::vector<Zone> m_zones;
+    cv::Size m_compiledSize;
+
+    cv::Mat m_includeMask;
+    // (rows + 1) x (cols + 1) CV_32S sums of m_includeMask (0 or 1 per pixel).
+    cv::Mat m_includeIntegral;
+    cv::Mat m_excludeMask;
+};
+
+}
@@ -0,0 +1,676 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSettings>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/batch_analyzer.h"
+#include "core/camera_manager.h"
+#include "modules/network/network_server.h"
+#include "arctic_owl/version.h"
+
+namespace {
+
+using ArcticOwl::Core::CameraManager;
+
+struct DaemonConfig {
+    std::vector<CameraManager::CameraSource> cameras;
+    int networkPort = 8080;
+    int metricsPort = 9464;
+    int streamCamera = 0;
+    bool passthrough = false;
+    int threadCount = 0;
+    double targetFps = 0.0;
+    double analysisScale = 1.0;
+    double morphologyScale = 1.0;
+    int detectionStride = 1;
+    ArcticOwl::Core::BackgroundModel::Engine backgroundEngine = ArcticOwl::Core::BackgroundModel::MOG2_KNN;
+    int statusIntervalSec = 10;
+    bool intrusionDetection = true;
+    bool fireDetection = true;
+    bool motionDetection = true;
+    bool equipmentFailureDetection = true;
+    // Fire detection only where the foreground changed, plus a full scan
+    // every fireSchedule.refreshInterval frames.
+    ArcticOwl::Core::Detector::Schedule fireSchedule{false, 50};
+    // Object detection for every live camera; off while the model path is
+    // empty.
+    ArcticOwl::Core::DnnInferenceQueue::Options objectDetector;
+    std::string objectLabelsPath;
+    int objectInterval = 5;
+    // Zones of cameras that define none, and of batch files.
+    std::vector<ArcticOwl::Core::Zone> zones;
+    std::vector<std::string> batchFiles;
+    std::string reportPath;
+    double batchSegmentSec = 300.0;
+    double batchWarmUpSec = 10.0;
+};
+
+std::atomic<bool> g_stopRequested{false};
+
+void handleStopSignal(int)
+{
+    g_stopRequested = true;
+}
+
+// "0" selects a local camera, "v4l2:0" the same camera through the native
+// V4L2 backend, rtsp:// and rtmp:// URLs select a stream.
+bool parseSource(const QString& text, CameraManager::CameraSource& source)
+{
+    QString value = text.trimmed();
+    if (value.isEmpty()) {
+        return false;
+    }
+
+    if (value.startsWith(QStringLiteral("v4l2:"))) {
+        source.v4l2.enabled = true;
+        value = value.mid(5);
+    }
+
+    if (value.startsWith(QStringLiteral("rtsp://"))) {
+        source.rtspUrl = value.toStdString();
+        return true;
+    }
+    if (value.startsWith(QStringLiteral("rtmp://"))) {
+        source.rtmpUrl = value.toStdString();
+        return true;
+    }
+
+    bool ok = false;
+    const int cameraId = value.toInt(&ok);
+    if (!ok || cameraId < 0) {
+        return false;
+    }
+
+    source.cameraId = cameraId;
+    return true;
+}
+
+bool parseBackgroundEngine(const QString& text, ArcticOwl::Core::BackgroundModel::Engine& engine)
+{
+    if (ArcticOwl::Core::BackgroundModel::parseEngine(text.trimmed().toStdString(), engine)) {
+        return true;
+    }
+
+    std::cerr << "Unknown background engine: " << text.toStdString()
+              << " (expected mog2+knn, mog2, knn or running-average)" << std::endl;
+    return false;
+}
+
+bool parseZone(const QString& kindText, const QString& polygonText, ArcticOwl::Core::Zone& zone)
+{
+    if (!ArcticOwl::Core::Zone::parseKind(kindText.trimmed().toStdString(), zone.kind)) {
+        std::cerr << "Unknown zone kind: " << kindText.toStdString() << " (expected include or exclude)" << std::endl;
+        return false;
+    }
+    if (!ArcticOwl::Core::Zone::parsePolygon(polygonText.toStdString(), zone.polygon)) {
+        std::cerr << "Invalid zone polygon: " << polygonText.toStdString()
+                  << " (expected at least three x,y vertices in [0, 1])" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Reads the "zones" array at the current settings position. An unquoted
+// polygon contains commas, which QSettings splits into a list; joining the
+// parts restores the text.
+bool readZones(QSettings& settings, std::vector<ArcticOwl::Core::Zone>& zones)
+{
+    const int zoneCount = settings.beginReadArray(QStringLiteral("zones"));
+    for (int i = 0; i < zoneCount; ++i) {
+        settings.setArrayIndex(i);
+
+        ArcticOwl::Core::Zone zone;
+        zone.name = settings.value(QStringLiteral("name")).toString().toStdString();
+        const QString polygon = settings.value(QStringLiteral("polygon")).toStringList().join(QLatin1Char(','));
+        if (!parseZone(settings.value(QStringLiteral("kind"), QStringLiteral("include")).toString(), polygon, zone)) {
+            return false;
+        }
+        zones.push_back(zone);
+    }
+    settings.endArray();
+    return true;
+}
+
+// One class name per line, in class index order.
+bool readClassNames(const std::string& path, std::vector<std::string>& names)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to read class names: " << path << std::endl;
+        return false;
+    }
+
+    names.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        names.push_back(line);
+    }
+    return true;
+}
+
+bool loadConfigFile(const QString& path, DaemonConfig& config)
+{
+    QSettings settings(path, QSettings::IniFormat);
+    if (settings.status() != QSettings::NoError) {
+        std::cerr << "Failed to read config file: " << path.toStdString() << std::endl;
+        return false;
+    }
+
+    config.networkPort = settings.value(QStringLiteral("network/port"), config.networkPort).toInt();
+    config.streamCamera = settings.value(QStringLiteral("network/stream_camera"), config.streamCamera).toInt();
+    config.passthrough = settings.value(QStringLiteral("network/passthrough"), config.passthrough).toBool();
+    config.metricsPort = settings.value(QStringLiteral("network/metrics_port"), config.metricsPort).toInt();
+    config.threadCount = settings.value(QStringLiteral("processing/threads"), config.threadCount).toInt();
+    config.targetFps = settings.value(QStringLiteral("processing/target_fps"), config.targetFps).toDouble();
+    config.analysisScale = settings.value(QStringLiteral("processing/analysis_scale"), config.analysisScale).toDouble();
+    config.morphologyScale = settings.value(QStringLiteral("processing/morphology_scale"), config.morphologyScale).toDouble();
+    config.detectionStride = settings.value(QStringLiteral("processing/detection_stride"), config.detectionStride).toInt();
+    if (settings.contains(QStringLiteral("processing/background"))
+        && !parseBackgroundEngine(settings.value(QStringLiteral("processing/background")).toString(),
+                                  config.backgroundEngine)) {
+        return false;
+    }
+    config.intrusionDetection = settings.value(QStringLiteral("detection/intrusion"), config.intrusionDetection).toBool();
+    config.fireDetection = settings.value(QStringLiteral("detection/fire"), config.fireDetection).toBool();
+    config.motionDetection = settings.value(QStringLiteral("detection/motion"), config.motionDetection).toBool();
+    config.equipmentFailureDetection = settings.value(QStringLiteral("detection/equipment"),
+                                                      config.equipmentFailureDetection).toBool();
+    config.fireSchedule.foregroundGated = settings.value(QStringLiteral("detection/fire_gating"),
+                                                         config.fireSchedule.foregroundGated).toBool();
+    config.fireSchedule.refreshInterval = settings.value(QStringLiteral("detection/fire_refresh_frames"),
+                                                         config.fireSchedule.refreshInterval).toInt();
+    auto& objects = config.objectDetector;
+    objects.modelPath = settings.value(QStringLiteral("objects/model"),
+                                       QString::fromStdString(objects.modelPath)).toString().toStdString();
+    config.objectLabelsPath = settings.value(QStringLiteral("objects/labels"),
+                                             QString::fromStdString(config.objectLabelsPath)).toString().toStdString();
+    objects.inputSize = settings.value(QStringLiteral("objects/input_size"), objects.inputSize).toInt();
+    objects.maxBatch = settings.value(QStringLiteral("objects/batch"), objects.maxBatch).toInt();
+    objects.batchWindowMs = settings.value(QStringLiteral("objects/batch_window_ms"), objects.batchWindowMs).toInt();
+    objects.confidenceThreshold = settings.value(QStringLiteral("objects/confidence"), objects.confidenceThreshold).toFloat();
+    objects.nmsThreshold = settings.value(QStringLiteral("objects/nms"), objects.nmsThreshold).toFloat();
+    config.objectInterval = settings.value(QStringLiteral("objects/interval"), config.objectInterval).toInt();
+    config.statusIntervalSec = settings.value(QStringLiteral("daemon/status_interval"), config.statusIntervalSec).toInt();
+    config.batchSegmentSec = settings.value(QStringLiteral("batch/segment_seconds"), config.batchSegmentSec).toDouble();
+    config.batchWarmUpSec = settings.value(QStringLiteral("batch/warmup_seconds"), config.batchWarmUpSec).toDouble();
+
+    if (!readZones(settings, config.zones)) {
+        return false;
+    }
+
+    const int cameraCount = settings.beginReadArray(QStringLiteral("cameras"));
+    for (int i = 0; i < cameraCount; ++i) {
+        settings.setArrayIndex(i);
+
+        CameraManager::CameraSource source;
+        const QString sourceText = settings.value(QStringLiteral("source")).toString();
+        if (!parseSource(sourceText, source)) {
+            std::cerr << "Ignoring invalid camera source in config: " << sourceText.toStdString() << std::endl;
+            continue;
+        }
+        source.location = settings.value(QStringLiteral("location")).toString().toStdString();
+        source.targetFps = settings.value(QStringLiteral("target_fps"), -1.0).toDouble();
+        source.analysisScale = settings.value(QStringLiteral("analysis_scale"), 0.0).toDouble();
+        source.backgroundEngine = config.backgroundEngine;
+        if (settings.contains(QStringLiteral("background"))
+            && !parseBackgroundEngine(settings.value(QStringLiteral("background")).toString(),
+                                      source.backgroundEngine)) {
+            return false;
+        }
+        if (!readZones(settings, source.zones)) {
+            return false;
+        }
+        if (source.zones.empty()) {
+            source.zones = config.zones;
+        }
+
+        auto& v4l2 = source.v4l2;
+        if (settings.value(QStringLiteral("backend")).toString().compare(QStringLiteral("v4l2"), Qt::CaseInsensitive) == 0) {
+            v4l2.enabled = true;
+        }
+        v4l2.width = settings.value(QStringLiteral("width"), v4l2.width).toInt();
+        v4l2.height = settings.value(QStringLiteral("height"), v4l2.height).toInt();
+        v4l2.fps = settings.value(QStringLiteral("fps"), v4l2.fps).toDouble();
+        v4l2.pixelFormat = settings.value(QStringLiteral("pixel_format"),
+                                          QString::fromStdString(v4l2.pixelFormat)).toString().toUpper().toStdString();
+        v4l2.bufferCount = settings.value(QStringLiteral("buffers"), v4l2.bufferCount).toInt();
+        config.cameras.push_back(source);
+    }
+    settings.endArray();
+
+    return true;
+}
+
+bool parseArguments(const QCoreApplication& app, DaemonConfig& config)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("ArcticOwl headless capture, detection and streaming daemon."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption configOption(QStringLiteral("config"),
+                                    QStringLiteral("INI configuration file."), QStringLiteral("file"));
+    QCommandLineOption sourceOption(QStringLiteral("source"),
+                                    QStringLiteral("Camera index, v4l2:<index>, or rtsp:// / rtmp:// URL. Repeatable."),
+                                    QStringLiteral("source"));
+    QCommandLineOption portOption(QStringLiteral("port"),
+                                  QStringLiteral("TCP port for the frame/alert stream."), QStringLiteral("port"));
+    QCommandLineOption metricsPortOption(QStringLiteral("metrics-port"),
+                                         QStringLiteral("Local HTTP port for /metrics (0 = disabled)."),
+                                         QStringLiteral("port"));
+    QCommandLineOption streamOption(QStringLiteral("stream-camera"),
+                                    QStringLiteral("Index of the camera streamed over TCP."), QStringLiteral("index"));
+    QCommandLineOption passthroughOption(QStringLiteral("passthrough"),
+                                         QStringLiteral("Stream MJPEG cameras as delivered and send overlays as JSON metadata."));
+    QCommandLineOption threadsOption(QStringLiteral("threads"),
+                                     QStringLiteral("Detection pool size (0 = core count)."), QStringLiteral("count"));
+    QCommandLineOption targetFpsOption(QStringLiteral("target-fps"),
+                                       QStringLiteral("Frames per second analysed per camera (0 = every frame)."),
+                                       QStringLiteral("fps"));
+    QCommandLineOption analysisScaleOption(QStringLiteral("analysis-scale"),
+                                           QStringLiteral("Downscale factor for detection, e.g. 0.5 (1 = native)."),
+                                           QStringLiteral("scale"));
+    QCommandLineOption morphologyScaleOption(QStringLiteral("morphology-scale"),
+                                             QStringLiteral("Resolution factor for mask cleanup, e.g. 0.5 (1 = analysis resolution)."),
+                                             QStringLiteral("scale"));
+    QCommandLineOption detectionStrideOption(QStringLiteral("detection-stride"),
+                                             QStringLiteral("Run full detection every N frames and track objects in between (1 = every frame)."),
+                                             QStringLiteral("frames"));
+    QCommandLineOption backgroundOption(QStringLiteral("background"),
+                                        QStringLiteral("Background engine for every camera: mog2+knn, mog2, knn or running-average."),
+                                        QStringLiteral("engine"));
+    QCommandLineOption zoneOption(QStringLiteral("zone"),
+                                  QStringLiteral("Zone for every camera and batch file, as include:<x,y x,y ...> or exclude:<...> "
+                                                 "with vertices in [0, 1]. Repeatable; replaces configured zones."),
+                                  QStringLiteral("zone"));
+    QCommandLineOption batchOption(QStringLiteral("batch"),
+                                   QStringLiteral("Analyse a video file offline as fast as possible, then exit. Repeatable."),
+                                   QStringLiteral("file"));
+    QCommandLineOption reportOption(QStringLiteral("report"),
+                                    QStringLiteral("Write the batch report (JSON) to a file instead of stdout."),
+                                    QStringLiteral("file"));
+    QCommandLineOption segmentOption(QStringLiteral("segment-seconds"),
+                                     QStringLiteral("Batch segment length analysed per task."), QStringLiteral("seconds"));
+    QCommandLineOption warmUpOption(QStringLiteral("warmup-seconds"),
+                                    QStringLiteral("Frames decoded before each batch segment to settle the background models."),
+                                    QStringLiteral("seconds"));
+    QCommandLineOption noIntrusionOption(QStringLiteral("no-intrusion"), QStringLiteral("Disable intrusion detection."));
+    QCommandLineOption noFireOption(QStringLiteral("no-fire"), QStringLiteral("Disable fire detection."));
+    QCommandLineOption noMotionOption(QStringLiteral("no-motion"), QStringLiteral("Disable motion detection."));
+    QCommandLineOption noEquipmentOption(QStringLiteral("no-equipment"),
+                                         QStringLiteral("Disable camera fault and tamper detection."));
+    QCommandLineOption fireGatingOption(QStringLiteral("fire-gating"),
+                                        QStringLiteral("Run fire detection only where the scene changed."));
+    QCommandLineOption fireRefreshOption(QStringLiteral("fire-refresh-frames"),
+                                         QStringLiteral("With --fire-gating, scan the whole frame every N frames (0 = never)."),
+                                         QStringLiteral("frames"));
+    QCommandLineOption objectModelOption(QStringLiteral("object-model"),
+                                         QStringLiteral("Detect objects on every camera with a YOLO ONNX model (CPU, batched across cameras)."),
+                                         QStringLiteral("file"));
+    QCommandLineOption objectLabelsOption(QStringLiteral("object-labels"),
+                                          QStringLiteral("Class names for --object-model, one per line."),
+                                          QStringLiteral("file"));
+    QCommandLineOption objectIntervalOption(QStringLiteral("object-interval"),
+                                            QStringLiteral("Submit every Nth analysed frame of each camera to the object model."),
+                                            QStringLiteral("frames"));
+
+    parser.addOptions({configOption, sourceOption, portOption, metricsPortOption, streamOption, passthroughOption,
+                       threadsOption, targetFpsOption, analysisScaleOption, morphologyScaleOption, detectionStrideOption,
+                       backgroundOption, zoneOption, batchOption, reportOption, segmentOption, warmUpOption,
+                       noIntrusionOption, noFireOption, noMotionOption, noEquipmentOption,
+                       fireGatingOption, fireRefreshOption, objectModelOption, objectLabelsOption,
+                       objectIntervalOption});
+    parser.process(app);
+
+    if (parser.isSet(configOption) && !loadConfigFile(parser.value(configOption), config)) {
+        return false;
+    }
+
+    for (const QString& value : parser.values(sourceOption)) {
+        CameraManager::CameraSource source;
+        source.targetFps = -1.0;
+        source.backgroundEngine = config.backgroundEngine;
+        source.zones = config.zones;
+        if (!parseSource(value, source)) {
+            std::cerr << "Invalid --source value: " << value.toStdString() << std::endl;
+            return false;
+        }
+        config.cameras.push_back(source);
+    }
+
+    if (parser.isSet(portOption)) {
+        config.networkPort = parser.value(portOption).toInt();
+    }
+    if (parser.isSet(metricsPortOption)) {
+        config.metricsPort = parser.value(metricsPortOption).toInt();
+    }
+    if (parser.isSet(streamOption)) {
+        config.streamCamera = parser.value(streamOption).toInt();
+    }
+    if (parser.isSet(passthroughOption)) {
+        config.passthrough = true;
+    }
+    if (parser.isSet(threadsOption)) {
+        config.threadCount = parser.value(threadsOption).toInt();
+    }
+    if (parser.isSet(noIntrusionOption)) {
+        config.intrusionDetection = false;
+    }
+    if (parser.isSet(noFireOption)) {
+        config.fireDetection = false;
+    }
+    if (parser.isSet(noMotionOption)) {
+        config.motionDetection = false;
+    }
+    if (parser.isSet(noEquipmentOption)) {
+        config.equipmentFailureDetection = false;
+    }
+    if (parser.isSet(fireGatingOption)) {
+        config.fireSchedule.foregroundGated = true;
+    }
+    if (parser.isSet(fireRefreshOption)) {
+        config.fireSchedule.refreshInterval = parser.value(fireRefreshOption).toInt();
+    }
+
+    if (parser.isSet(targetFpsOption)) {
+        config.targetFps = parser.value(targetFpsOption).toDouble();
+    }
+    if (parser.isSet(analysisScaleOption)) {
+        config.analysisScale = parser.value(analysisScaleOption).toDouble();
+    }
+    if (config.analysisScale <= 0.0 || config.analysisScale > 1.0) {
+        std::cerr << "Analysis scale must be in (0, 1]." << std::endl;
+        return false;
+    }
+    if (parser.isSet(morphologyScaleOption)) {
+        config.morphologyScale = parser.value(morphologyScaleOption).toDouble();
+    }
+    if (config.morphologyScale <= 0.0 || config.morphologyScale > 1.0) {
+        std::cerr << "Morphology scale must be in (0, 1]." << std::endl;
+        return false;
+    }
+
+    if (parser.isSet(objectModelOption)) {
+        config.objectDetector.modelPath = parser.value(objectModelOption).toStdString();
+    }
+    if (parser.isSet(objectLabelsOption)) {
+        config.objectLabelsPath = parser.value(objectLabelsOption).toStdString();
+    }
+    if (parser.isSet(objectIntervalOption)) {
+        config.objectInterval = parser.value(objectIntervalOption).toInt();
+    }
+    if (config.objectInterval < 1) {
+        std::cerr << "Object interval must be at least 1." << std::endl;
+        return false;
+    }
+    if (!config.objectLabelsPath.empty()
+        && !readClassNames(config.objectLabelsPath, config.objectDetector.classNames)) {
+        return false;
+    }
+
+    if (parser.isSet(detectionStrideOption)) {
+        config.detectionStride = parser.value(detectionStrideOption).toInt();
+    }
+    if (config.detectionStride < 1) {
+        std::cerr << "Detection stride must be at least 1." << std::endl;
+        return false;
+    }
+
+    // The flag overrides the config file, including per-camera engines.
+    if (parser.isSet(backgroundOption)) {
+        if (!parseBackgroundEngine(parser.value(backgroundOption), config.backgroundEngine)) {
+            return false;
+        }
+        for (auto& source : config.cameras) {
+            source.backgroundEngine = config.backgroundEngine;
+        }
+    }
+
+    // Like --background, the flag overrides the config file.
+    if (parser.isSet(zoneOption)) {
+        config.zones.clear();
+        for (const QString& value : parser.values(zoneOption)) {
+            const int separator = value.indexOf(QLatin1Char(':'));
+            ArcticOwl::Core::Zone zone;
+            if (separator < 0 || !parseZone(value.left(separator), value.mid(separator + 1), zone)) {
+                std::cerr << "Invalid --zone value: " << value.toStdString() << std::endl;
+                return false;
+            }
+            config.zones.push_back(zone);
+        }
+        for (auto& source : config.cameras) {
+            source.zones = config.zones;
+        }
+    }
+
+    // Cameras without their own target_fps inherit the global one.
+    for (auto& source : config.cameras) {
+        if (source.targetFps < 0.0) {
+            source.targetFps = config.targetFps;
+        }
+    }
+
+    for (const QString& value : parser.values(batchOption)) {
+        config.batchFiles.push_back(value.toStdString());
+    }
+    if (parser.isSet(reportOption)) {
+        config.reportPath = parser.value(reportOption).toStdString();
+    }
+    if (parser.isSet(segmentOption)) {
+        config.batchSegmentSec = parser.value(segmentOption).toDouble();
+    }
+    if (parser.isSet(warmUpOption)) {
+        config.batchWarmUpSec = parser.value(warmUpOption).toDouble();
+    }
+
+    if (config.batchSegmentSec <= 0.0 || config.batchWarmUpSec < 0.0) {
+        std::cerr << "Batch segment length must be positive and warm-up non-negative." << std::endl;
+        return false;
+    }
+
+    if (config.cameras.empty() && config.batchFiles.empty()) {
+        std::cerr << "No camera sources configured. Use --source, --batch or a [cameras] section in --config." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void printStatus(const CameraManager& manager)
+{
+    for (const auto& status : manager.cameraStatuses()) {
+        std::cout << "[camera " << status.index << "] " << status.location
+                  << " state=" << status.state
+                  << " fps=" << status.fps
+                  << " source_fps=" << status.sourceFps
+                  << " processed=" << status.processedFrames
+                  << " dropped=" << status.droppedFrames
+                  << " reconnects=" << status.reconnects << std::endl;
+    }
+}
+
+int runBatch(const DaemonConfig& config)
+{
+    ArcticOwl::Core::BatchAnalyzer::Options options;
+    options.segmentSeconds = config.batchSegmentSec;
+    options.warmUpSeconds = config.batchWarmUpSec;
+    options.threadCount = static_cast<std::size_t>(std::max(0, config.threadCount));
+    options.intrusionDetection = config.intrusionDetection;
+    options.fireDetection = config.fireDetection;
+    options.motionDetection = config.motionDetection;
+    options.equipmentFailureDetection = config.equipmentFailureDetection;
+    options.analysisScale = config.analysisScale;
+    options.backgroundEngine = config.backgroundEngine;
+    options.morphologyScale = config.morphologyScale;
+    options.detectionStride = config.detectionStride;
+    options.fireSchedule = config.fireSchedule;
+    options.zones = config.zones;
+    if (!config.objectDetector.modelPath.empty()) {
+        std::cerr << "Object detection runs on live cameras only; ignored for batch analysis." << std::endl;
+    }
+
+    // Segments already occupy every core; OpenCV's own worker threads would
+    // only oversubscribe them.
+    cv::setNumThreads(1);
+
+    std::ofstream reportFile;
+    if (!config.reportPath.empty()) {
+        reportFile.open(config.reportPath);
+        if (!reportFile) {
+            std::cerr << "Failed to open report file: " << config.reportPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = config.reportPath.empty() ? std::cout : reportFile;
+
+    ArcticOwl::Core::BatchAnalyzer analyzer(options);
+    int exitCode = 0;
+    bool firstReport = true;
+
+    out << "[\n";
+    for (const std::string& path : config.batchFiles) {
+        ArcticOwl::Core::BatchAnalyzer::Report report;
+        const bool ok = analyzer.analyzeFile(path, report, [&path](std::size_t done, std::size_t total) {
+            std::cerr << "\r" << path << ": " << done << "/" << total << " segments" << std::flush;
+        });
+        std::cerr << std::endl;
+
+        if (!ok) {
+            exitCode = 1;
+            continue;
+        }
+
+        std::cerr << path << ": " << report.frameCount << " frames in " << report.wallSeconds << " s ("
+                  << (report.wallSeconds > 0.0 ? report.frameCount / report.wallSeconds : 0.0) << " fps), "
+                  << report.events.size() << " events" << std::endl;
+
+        if (!firstReport) {
+            out << ",\n";
+        }
+        firstReport = false;
+        ArcticOwl::Core::BatchAnalyzer::writeReport(report, out);
+    }
+    out << "]\n";
+
+    return exitCode;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("arcticowl-headless");
+    app.setApplicationVersion(QString::fromLatin1(ArcticOwl::Version::kString));
+
+    DaemonConfig config;
+    if (!parseArguments(app, config)) {
+        return 1;
+    }
+
+    if (!config.batchFiles.empty()) {
+        return runBatch(config);
+    }
+
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+
+    try {
+        ArcticOwl::Modules::Network::NetworkServer networkServer(config.networkPort);
+        if (config.metricsPort > 0 && networkServer.enableMetricsEndpoint(static_cast<unsigned short>(config.metricsPort))) {
+            std::cout << "Metrics available on http://127.0.0.1:" << config.metricsPort << "/metrics" << std::endl;
+        }
+        CameraManager manager(nullptr, static_cast<std::size_t>(std::max(0, config.threadCount)));
+
+        for (const auto& source : config.cameras) {
+            manager.addCamera(source);
+        }
+
+        manager.setIntrusionDetection(config.intrusionDetection);
+        manager.setFireDetection(config.fireDetection);
+        manager.setMotionDetection(config.motionDetection);
+        manager.setEquipmentFailureDetection(config.equipmentFailureDetection);
+        manager.setAnalysisScale(config.analysisScale);
+        manager.setMorphologyScale(config.morphologyScale);
+        manager.setDetectionStride(config.detectionStride);
+        manager.setDetectorSchedule("fire", config.fireSchedule);
+        if (!config.objectDetector.modelPath.empty()) {
+            auto objectQueue = ArcticOwl::Core::DnnInferenceQueue::create(config.objectDetector);
+            if (!objectQueue) {
+                return 1;
+            }
+            manager.setObjectDetection(std::move(objectQueue), config.objectInterval);
+        }
+
+        // No GUI: keep frameProcessed silent and stream straight from the pool.
+        manager.setPreviewCamera(-1);
+        const int streamCamera = config.streamCamera;
+        manager.setFrameSink([&networkServer, &manager, streamCamera](const ArcticOwl::Core::Frame& annotatedFrame,
+                                                                      const std::vector<ArcticOwl::Core::VideoProcessor::DetectionResult>& results) {
+            if (annotatedFrame.cameraIndex != streamCamera) {
+                return;
+            }
+            // Passthrough cameras already stream their own JPEG; only the
+            // overlays are left to send.
+            if (manager.isPassthroughActive(annotatedFrame.cameraIndex)) {
+                networkServer.sendDetections(annotatedFrame, results);
+            } else {
+                networkServer.broadcastFrame(annotatedFrame);
+            }
+        });
+        if (config.passthrough) {
+            manager.setCompressedFrameSink([&networkServer, streamCamera](const ArcticOwl::Core::Frame& encoded) {
+                if (encoded.cameraIndex == streamCamera) {
+                    networkServer.broadcastEncodedFrame(encoded);
+                }
+            });
+        }
+
+        if (!manager.startCameraSystem()) {
+            std::cerr << "Failed to start any camera." << std::endl;
+            return 1;
+        }
+        networkServer.startNetworkSystem();
+
+        QTimer stopTimer;
+        QObject::connect(&stopTimer, &QTimer::timeout, &app, [&app]() {
+            if (g_stopRequested) {
+                app.quit();
+            }
+        });
+        stopTimer.start(200);
+
+        QTimer statusTimer;
+        if (config.statusIntervalSec > 0) {
+            QObject::connect(&statusTimer, &QTimer::timeout, &app, [&manager]() {
+                printStatus(manager);
+            });
+            statusTimer.start(config.statusIntervalSec * 1000);
+        }
+
+        const int exitCode = app.exec();
+
+        manager.stopCameraSystem();
+        networkServer.stopNetworkSystem();
+        return exitCode;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unexpected fatal error." << std::endl;
+    }
+
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <istream>
+#include <sstream>
+
+#include "metrics_endpoint.h"
+
+namespace ArcticOwl::Modules::Network {
+
+MetricsEndpoint::MetricsEndpoint(boost::asio::io_context& ioContext, unsigned short port, RenderFunction render)
+    : m_ioContext(ioContext),
+      m_acceptor(ioContext, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port)),
+      m_render(std::move(render)),
+      m_port(port)
+{
+}
+
+void MetricsEndpoint::start()
+{
+    acceptConnections();
+}
+
+void MetricsEndpoint::stop()
+{
+    boost::system::error_code ec;
+    m_acceptor.close(ec);
+}
+
+void MetricsEndpoint::acceptConnections()
+{
+    auto request = std::make_shared<Request>(m_ioContext);
+    m_acceptor.async_accept(request->socket, [this, request](boost::system::error_code ec) {
+        if (!ec) {
+            readRequest(request);
+        }
+
+        if (m_acceptor.is_open()) {
+            acceptConnections();
+        }
+    });
+}
+
+void MetricsEndpoint::readRequest(std::shared_ptr<Request> request)
+{
+    boost::asio::async_read_until(request->socket, request->buffer, "\r\n\r\n",
+        [this, request](boost::system::error_code ec, std::size_t) {
+            if (ec) {
+                boost::system::error_code ignored;
+                request->socket.close(ignored);
+                return;
+            }
+
+            std::istream stream(&request->buffer);
+            std::string method;
+            std::string target;
+            stream >> method >> target;
+
+            if (method != "GET") {
+                writeResponse(request, "405 Method Not Allowed", "");
+                return;
+            }
+            if (target != "/metrics") {
+                writeResponse(request, "404 Not Found", "");
+                return;
+            }
+
+            try {
+                writeResponse(request, "200 OK", m_render ? m_render() : std::string());
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to render metrics: " << e.what() << std::endl;
+                writeResponse(request, "500 Internal Server Error", "");
+            }
+    });
+}
+
+void MetricsEndpoint::writeResponse(std::shared_ptr<Request> request, const std::string& status, const std::string& body)
+{
+    std::ostringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    request->response = response.str();
+
+    boost::asio::async_write(request->socket, boost::asio::buffer(request->response),
+        [request](boost::system::error_code, std::size_t) {
+            boost::system::error_code ec;
+            request->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            request->socket.close(ec);
+    });
+}
+
+}
\ No newline at end of file
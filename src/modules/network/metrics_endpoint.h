@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ArcticOwl::Modules::Network {
+
+// Minimal HTTP/1.0 responder for Prometheus scrapes. Runs entirely on the
+// io_context it is given, so the render callback executes on that thread.
+class MetricsEndpoint {
+public:
+    using RenderFunction = std::function<std::string()>;
+
+    MetricsEndpoint(boost::asio::io_context& ioContext, unsigned short port, RenderFunction render);
+
+    void start();
+    void stop();
+
+    unsigned short port() const { return m_port; }
+
+private:
+    // Scrapers send a request line plus a few headers; anything larger is refused.
+    static constexpr std::size_t kMaxRequestSize = 8192;
+
+    struct Request {
+        explicit Request(boost::asio::io_context& ioContext) : socket(ioContext), buffer(kMaxRequestSize) {}
+
+        boost::asio::ip::tcp::socket socket;
+        boost::asio::streambuf buffer;
+        std::string response;
+    };
+
+    void acceptConnections();
+    void readRequest(std::shared_ptr<Request> request);
+    void writeResponse(std::shared_ptr<Request> request, const std::string& status, const std::string& body);
+
+    boost::asio::io_context& m_ioContext;
+    boost::asio::ip::tcp::acceptor m_acceptor;
+    RenderFunction m_render;
+    unsigned short m_port;
+};
+
+}
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <sstream>
 
 #include "network_server.h"
 
@@ -7,9 +10,27 @@ namespace ArcticOwl::Modules::Network {
 NetworkServer::NetworkServer(int port)
     : m_acceptor(m_ioContext, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)),
       m_running(false),
-      m_port(port)
+      m_port(port),
+      m_encodeLatency(Core::MetricsRegistry::instance().histogram(
+          "arcticowl_network_encode_seconds", "Time spent JPEG-encoding a broadcast frame.")),
+      m_passthroughFrames(Core::MetricsRegistry::instance().counter(
+          "arcticowl_network_passthrough_frames_total", "Source JPEG frames broadcast without re-encoding.")),
+      m_writeLatency(Core::MetricsRegistry::instance().histogram(
+          "arcticowl_network_write_seconds", "Time from starting a client write until it completes.")),
+      m_sentAge(Core::MetricsRegistry::instance().histogram(
+          "arcticowl_frame_age_seconds", "Time from grab() until a frame reaches a stage.",
+          Core::MetricsRegistry::label("stage", "sent"))),
+      m_backlogDrops(Core::MetricsRegistry::instance().counter(
+          "arcticowl_dropped_frames_total", "Frames dropped before reaching the next stage.",
+          Core::MetricsRegistry::label("reason", "client_backlog")))
 {
     m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+
+    auto reply = std::make_shared<OutgoingMessage>();
+    const std::string handshake = kProtocolHandshake;
+    reply->payload.assign(handshake.begin(), handshake.end());
+    reply->size = static_cast<uint32_t>(reply->payload.size());
+    m_handshakeReply = std::move(reply);
 }
 
 NetworkServer::~NetworkServer()
@@ -26,6 +47,9 @@ void NetworkServer::startNetworkSystem()
     m_running = true;
     m_serverThread = std::thread([this]() {
         acceptConnections();
+        if (m_metricsEndpoint) {
+            m_metricsEndpoint->start();
+        }
         m_ioContext.run();
     });
 }
@@ -37,35 +61,48 @@ void NetworkServer::stopNetworkSystem()
     }
 
     m_running = false;
-    m_acceptor.close();
     m_ioContext.stop();
 
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    if (m_serverThread.joinable()) {
+        m_serverThread.join();
+    }
+
+    // The io_context is stopped, so sessions are no longer touched concurrently.
+    boost::system::error_code ec;
+    m_acceptor.close(ec);
+    if (m_metricsEndpoint) {
+        m_metricsEndpoint->stop();
+    }
+
     for (auto& client : m_clients) {
-        if (client->is_open()) {
-            boost::system::error_code ec;
-            client->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-            client->close(ec);
+        if (client->socket.is_open()) {
+            client->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            client->socket.close(ec);
         }
     }
     m_clients.clear();
-    
-    if (m_serverThread.joinable()) {
-        m_serverThread.join();
-    }
+}
+
+int NetworkServer::port() const
+{
+    boost::system::error_code ec;
+    const auto endpoint = m_acceptor.local_endpoint(ec);
+    return ec ? m_port : endpoint.port();
 }
 
 void NetworkServer::acceptConnections()
 {
-    auto socket = std::make_shared<boost::asio::ip::tcp::socket>(m_ioContext);
-    m_acceptor.async_accept(*socket, [this, socket](boost::system::error_code ec) {
+    auto session = std::make_shared<ClientSession>(m_ioContext);
+    m_acceptor.async_accept(session->socket, [this, session](boost::system::error_code ec) {
         if (!ec) {
-            std::cout << "Client connected: " << socket->remote_endpoint() << std::endl;
+            boost::system::error_code endpointError;
+            std::ostringstream peer;
+            peer << session->socket.remote_endpoint(endpointError);
+            session->peer = peer.str();
+            std::cout << "Client connected: " << session->peer << std::endl;
 
-            std::lock_guard<std::mutex> lock(m_clientsMutex);
-            m_clients.push_back(socket);
-            
-            handleClient(socket);
+            m_clients.push_back(session);
+            handleClient(session);
         }
 
         if (m_running) {
@@ -74,56 +111,248 @@ void NetworkServer::acceptConnections()
     });
 }
 
-void NetworkServer::handleClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket)
+void NetworkServer::handleClient(std::shared_ptr<ClientSession> session)
 {
     auto buffer = std::make_shared<std::vector<char>>(1024);
 
-    socket->async_read_some(boost::asio::buffer(*buffer),
-        [this, socket, buffer](boost::system::error_code ec, std::size_t length) {
+    session->socket.async_read_some(boost::asio::buffer(*buffer),
+        [this, session, buffer](boost::system::error_code ec, std::size_t length) {
             if (!ec) {
-                std::string message(buffer->begin(), buffer->begin() + length);
-                std::cout << "Received message: " << message << std::endl;
+                session->received.append(buffer->begin(), buffer->begin() + length);
+                std::size_t end;
+                while ((end = session->received.find('\n')) != std::string::npos) {
+                    std::string line = session->received.substr(0, end);
+                    session->received.erase(0, end + 1);
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    handleLine(session, line);
+                }
+                // Not a line-based client; do not buffer its bytes forever.
+                if (session->received.size() > buffer->size()) {
+                    std::cout << "Received message: " << session->received << std::endl;
+                    session->received.clear();
+                }
 
-                handleClient(socket);
+                handleClient(session);
             } else {
                 std::cout << "Client disconnected" << std::endl;
+                removeClient(session);
+            }
+    });
+}
 
-                {
-                    std::lock_guard<std::mutex> lock(m_clientsMutex);
-                    auto it = std::find_if(m_clients.begin(), m_clients.end(),
-                        [socket](const std::shared_ptr<boost::asio::ip::tcp::socket>& s) {
-                            return s == socket;
-                        });
+void NetworkServer::handleLine(const std::shared_ptr<ClientSession>& session, const std::string& line)
+{
+    if (line != kProtocolHandshake) {
+        std::cout << "Received message: " << line << std::endl;
+        return;
+    }
+    if (session->typeRequested) {
+        return;
+    }
 
-                    if (it != m_clients.end()) {
-                        m_clients.erase(it);
-                    }
-                }
+    // The reply goes out next, after the message being written if any, so
+    // the client knows exactly where typed messages begin.
+    session->typeRequested = true;
+    auto position = session->outbox.begin();
+    if (session->writing && position != session->outbox.end()) {
+        ++position;
+    }
+    session->outbox.insert(position, m_handshakeReply);
+    if (!session->writing) {
+        writeNext(session);
+    }
+}
+
+void NetworkServer::queueMessage(std::shared_ptr<const OutgoingMessage> message)
+{
+    boost::asio::post(m_ioContext, [this, message]() {
+        for (auto& client : m_clients) {
+            if (message->type == MessageType::Detections && !client->typeRequested) {
+                continue;
+            }
+            if (message->droppable && client->outbox.size() >= kMaxClientBacklog) {
+                ++client->droppedMessages;
+                m_backlogDrops.inc();
+                continue;
+            }
+
+            client->outbox.push_back(message);
+            if (!client->writing) {
+                writeNext(client);
+            }
+        }
+    });
+}
+
+void NetworkServer::writeNext(std::shared_ptr<ClientSession> session)
+{
+    if (session->outbox.empty()) {
+        session->writing = false;
+        return;
+    }
+
+    session->writing = true;
+    auto message = session->outbox.front();
+    // Clients on the original protocol get no type byte.
+    std::array<boost::asio::const_buffer, 3> buffers = {
+        boost::asio::buffer(&message->size, sizeof(message->size)),
+        boost::asio::buffer(&message->type, session->typed ? sizeof(message->type) : 0),
+        boost::asio::buffer(message->payload)
+    };
+    if (message == m_handshakeReply) {
+        session->typed = true;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    boost::asio::async_write(session->socket, buffers,
+        [this, session, message, started](boost::system::error_code ec, std::size_t length) {
+            const auto finished = std::chrono::steady_clock::now();
+            m_writeLatency.observe(std::chrono::duration<double>(finished - started).count());
+            if (!ec && message->sequence > 0) {
+                // Glass-to-client: capture until the last byte left this host.
+                m_sentAge.observe(std::chrono::duration<double>(finished - message->captureTime).count());
+            }
+            session->bytesSent += length;
+
+            if (!session->outbox.empty() && session->outbox.front() == message) {
+                session->outbox.pop_front();
+            }
+
+            if (ec) {
+                std::cerr << "Failed to send message: " << ec.message() << std::endl;
+                removeClient(session);
+                return;
             }
+
+            writeNext(session);
     });
 }
 
+void NetworkServer::removeClient(const std::shared_ptr<ClientSession>& session)
+{
+    session->outbox.clear();
+    session->writing = false;
+
+    auto it = std::find(m_clients.begin(), m_clients.end(), session);
+    if (it != m_clients.end()) {
+        m_clients.erase(it);
+    }
+
+    boost::system::error_code ec;
+    session->socket.close(ec);
+}
+
 void NetworkServer::broadcastFrame(const cv::Mat& frame)
+{
+    if (!m_running || frame.empty()) {
+        return;
+    }
+
+    auto message = acquireFrameMessage();
+    encodeFrame(frame, *message);
+    message->sequence = 0;
+
+    queueFrameMessage(std::move(message));
+}
+
+void NetworkServer::broadcastFrame(const Core::Frame& frame)
+{
+    if (!m_running || frame.empty()) {
+        return;
+    }
+
+    auto message = acquireFrameMessage();
+    encodeFrame(frame.image, *message);
+    message->sequence = frame.sequence;
+    message->captureTime = frame.captureTime;
+
+    queueFrameMessage(std::move(message));
+}
+
+void NetworkServer::encodeFrame(const cv::Mat& frame, OutgoingMessage& message)
+{
+    static const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, 60};
+
+    Core::StageTimer timer(&m_encodeLatency);
+    cv::imencode(".jpg", frame, message.payload, params);
+}
+
+void NetworkServer::broadcastEncodedFrame(const Core::Frame& encoded)
+{
+    if (!m_running || encoded.empty() || !encoded.image.isContinuous()) {
+        return;
+    }
+
+    auto message = acquireFrameMessage();
+    const uchar* data = encoded.image.ptr();
+    message->payload.assign(data, data + encoded.image.total() * encoded.image.elemSize());
+    message->sequence = encoded.sequence;
+    message->captureTime = encoded.captureTime;
+    m_passthroughFrames.inc();
+
+    queueFrameMessage(std::move(message));
+}
+
+void NetworkServer::queueFrameMessage(std::shared_ptr<OutgoingMessage> message)
+{
+    message->size = static_cast<uint32_t>(message->payload.size());
+    message->type = MessageType::Frame;
+    message->droppable = true;
+
+    queueMessage(std::move(message));
+}
+
+void NetworkServer::sendDetections(const Core::Frame& frame,
+                                   const std::vector<Core::VideoProcessor::DetectionResult>& results)
 {
     if (!m_running) {
         return;
     }
 
-    std::vector<uchar> buffer;
-    std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, 60};
-    cv::imencode(".jpg", frame, buffer, params);
+    std::ostringstream json;
+    json << "{\"sequence\": " << frame.sequence << ", \"pts_ms\": " << frame.ptsMs
+         << ", \"width\": " << frame.image.cols << ", \"height\": " << frame.image.rows << ", \"detections\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const cv::Rect& box = result.boundingBox;
+        json << (i == 0 ? "" : ", ")
+             << "{\"type\": \"" << Core::VideoProcessor::typeName(result.type) << "\""
+             << ", \"confidence\": " << result.confidence
+             << ", \"track\": " << result.trackId
+             << ", \"class\": " << result.classId
+             << ", \"box\": [" << box.x << ", " << box.y << ", " << box.width << ", " << box.height << "]}";
+    }
+    json << "]}";
 
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
-    for (auto& client : m_clients) {
-        try {
-            uint32_t size = buffer.size();
-            boost::asio::write(*client, boost::asio::buffer(&size, sizeof(size)));
+    // Stale overlays are worthless, so they share the frames' backlog policy.
+    auto message = std::make_shared<OutgoingMessage>();
+    const std::string text = json.str();
+    message->payload.assign(text.begin(), text.end());
+    message->size = static_cast<uint32_t>(message->payload.size());
+    message->type = MessageType::Detections;
+    message->droppable = true;
+
+    queueMessage(std::move(message));
+}
 
-            boost::asio::write(*client, boost::asio::buffer(buffer));
-        } catch (const std::exception& e) {
-            std::cerr << "Failed to send frame: " << e.what() << std::endl;
+std::shared_ptr<NetworkServer::OutgoingMessage> NetworkServer::acquireFrameMessage()
+{
+    std::lock_guard<std::mutex> lock(m_frameMessagePoolMutex);
+
+    for (const auto& message : m_frameMessagePool) {
+        if (message.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return message;
         }
     }
+
+    auto message = std::make_shared<OutgoingMessage>();
+    if (m_frameMessagePool.size() < kFrameMessagePoolSize) {
+        m_frameMessagePool.push_back(message);
+    }
+    return message;
 }
 
 void NetworkServer::sendAlert(const std::string& alertMessage)
@@ -132,16 +361,64 @@ void NetworkServer::sendAlert(const std::string& alertMessage)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
-    for (auto& client : m_clients) {
-        try {
-            uint32_t size = alertMessage.size();
-            boost::asio::write(*client, boost::asio::buffer(&size, sizeof(size)));
-            boost::asio::write(*client, boost::asio::buffer(alertMessage));
-        } catch (const std::exception& e) {
-            std::cerr << "Failed to send alert: " << e.what() << std::endl;
-        }
+    auto message = std::make_shared<OutgoingMessage>();
+    message->payload.assign(alertMessage.begin(), alertMessage.end());
+    message->size = static_cast<uint32_t>(message->payload.size());
+    message->type = MessageType::Alert;
+
+    queueMessage(std::move(message));
+}
+
+bool NetworkServer::enableMetricsEndpoint(unsigned short port)
+{
+    if (m_running || m_metricsEndpoint) {
+        return false;
     }
+
+    try {
+        m_metricsEndpoint = std::make_unique<MetricsEndpoint>(m_ioContext, port, [this]() {
+            return renderMetrics();
+        });
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to open metrics endpoint on port " << port << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::string NetworkServer::renderMetrics() const
+{
+    // Called from the metrics endpoint, which runs on the server thread, so the
+    // client sessions can be read without further synchronisation.
+    std::ostringstream out;
+    out << Core::MetricsRegistry::instance().renderText();
+
+    out << "# HELP arcticowl_network_clients Connected stream clients.\n"
+        << "# TYPE arcticowl_network_clients gauge\n"
+        << "arcticowl_network_clients " << m_clients.size() << "\n";
+
+    out << "# HELP arcticowl_client_bytes_sent_total Bytes written to a stream client.\n"
+        << "# TYPE arcticowl_client_bytes_sent_total counter\n";
+    for (const auto& client : m_clients) {
+        out << "arcticowl_client_bytes_sent_total{" << Core::MetricsRegistry::label("client", client->peer) << "} "
+            << client->bytesSent << "\n";
+    }
+
+    out << "# HELP arcticowl_client_backlog_messages Messages queued for a stream client.\n"
+        << "# TYPE arcticowl_client_backlog_messages gauge\n";
+    for (const auto& client : m_clients) {
+        out << "arcticowl_client_backlog_messages{" << Core::MetricsRegistry::label("client", client->peer) << "} "
+            << client->outbox.size() << "\n";
+    }
+
+    out << "# HELP arcticowl_client_dropped_messages_total Frames skipped for a stream client with a full backlog.\n"
+        << "# TYPE arcticowl_client_dropped_messages_total counter\n";
+    for (const auto& client : m_clients) {
+        out << "arcticowl_client_dropped_messages_total{" << Core::MetricsRegistry::label("client", client->peer) << "} "
+            << client->droppedMessages << "\n";
+    }
+
+    return out.str();
 }
-    
+
 }
\ No newline at end of file
@@ -1,39 +1,135 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <chrono>
 #include <thread>
 #include <memory>
 #include <vector>
+#include <deque>
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <iostream>
 #include <string>
 #include <opencv2/opencv.hpp>
 
+#include "core/frame.h"
+#include "core/metrics.h"
+#include "core/video_processor.h"
+#include "metrics_endpoint.h"
+
 namespace ArcticOwl::Modules::Network {
 
+// Every message goes out as a uint32 payload length (little endian) followed
+// by the payload, as in the original protocol. A client that sends the line
+// kProtocolHandshake gets kProtocolHandshake back as one such message; every
+// later message has a MessageType byte between length and payload. Clients
+// that never ask are not sent Detections, which they could not tell apart.
 class NetworkServer {
 public:
+    static constexpr const char* kProtocolHandshake = "ARCTICOWL/2";
+
+    enum class MessageType : std::uint8_t {
+        // JPEG image, either encoded here or forwarded from the source.
+        Frame = 0,
+        // UTF-8 text from sendAlert.
+        Alert = 1,
+        // UTF-8 JSON from sendDetections.
+        Detections = 2
+    };
+
     NetworkServer(int port);
     ~NetworkServer();
 
     void startNetworkSystem();
     void stopNetworkSystem();
 
+    // Actual listening port; differs from the constructor argument when that was 0.
+    int port() const;
+
+    // Both calls only queue the payload; socket writes happen on the server
+    // thread so callers (processing workers, UI) never block on slow clients.
     void broadcastFrame(const cv::Mat& frame);
+    // Same, and records the frame's age when each client write completes.
+    void broadcastFrame(const Core::Frame& frame);
     void sendAlert(const std::string& alertMessage);
 
+    // Passthrough for sources that already deliver JPEG: encoded.image holds
+    // the bitstream, which is copied into a pooled message and sent without
+    // decoding or re-encoding.
+    void broadcastEncodedFrame(const Core::Frame& encoded);
+    // Overlays for passthrough frames, sent as a droppable Detections message:
+    // {"sequence": N, "pts_ms": T, "width": W, "height": H, "detections": [
+    //   {"type": "motion", "confidence": C, "track": ID, "class": K, "box": [x, y, w, h]}]}
+    // Boxes are in the width x height coordinates of the analysed frame.
+    // track is -1 for untracked results, class is -1 except for object results.
+    void sendDetections(const Core::Frame& frame, const std::vector<Core::VideoProcessor::DetectionResult>& results);
+
+    // Serves the process metrics registry plus per-client statistics on
+    // http://127.0.0.1:<port>/metrics. Must be called before startNetworkSystem.
+    bool enableMetricsEndpoint(unsigned short port);
+
 private:
+    struct OutgoingMessage {
+        uint32_t size = 0;
+        MessageType type = MessageType::Frame;
+        std::vector<uchar> payload;
+        bool droppable = false;
+        // Set for frames that came with an envelope; 0 otherwise.
+        std::uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point captureTime;
+    };
+
+    struct ClientSession {
+        explicit ClientSession(boost::asio::io_context& ioContext) : socket(ioContext) {}
+
+        boost::asio::ip::tcp::socket socket;
+        std::deque<std::shared_ptr<const OutgoingMessage>> outbox;
+        bool writing = false;
+        std::string peer;
+        // Partial line received from the client, for the handshake.
+        std::string received;
+        // Set when the client asked for typed messages; they start after
+        // the handshake reply.
+        bool typeRequested = false;
+        bool typed = false;
+        uint64_t bytesSent = 0;
+        uint64_t droppedMessages = 0;
+    };
+
     void acceptConnections();
-    void handleClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+    void handleClient(std::shared_ptr<ClientSession> session);
+    void handleLine(const std::shared_ptr<ClientSession>& session, const std::string& line);
+    void queueMessage(std::shared_ptr<const OutgoingMessage> message);
+    void writeNext(std::shared_ptr<ClientSession> session);
+    void removeClient(const std::shared_ptr<ClientSession>& session);
+    std::shared_ptr<OutgoingMessage> acquireFrameMessage();
+    void encodeFrame(const cv::Mat& frame, OutgoingMessage& message);
+    void queueFrameMessage(std::shared_ptr<OutgoingMessage> message);
+    std::string renderMetrics() const;
+
+    static constexpr std::size_t kMaxClientBacklog = 4;
+    static constexpr std::size_t kFrameMessagePoolSize = kMaxClientBacklog + 2;
 
     boost::asio::io_context m_ioContext;
     boost::asio::ip::tcp::acceptor m_acceptor;
-    std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> m_clients;
-    std::mutex m_clientsMutex;
+    std::vector<std::shared_ptr<ClientSession>> m_clients;
+    // Sent untyped to a client that asked for typed messages; switches it.
+    std::shared_ptr<const OutgoingMessage> m_handshakeReply;
+    // Encoded frames are recycled once no client outbox references them, so
+    // the JPEG buffers keep their capacity instead of being reallocated.
+    std::vector<std::shared_ptr<OutgoingMessage>> m_frameMessagePool;
+    std::mutex m_frameMessagePoolMutex;
+    std::unique_ptr<MetricsEndpoint> m_metricsEndpoint;
     std::thread m_serverThread;
     std::atomic<bool> m_running;
     short m_port;
+
+    Core::Histogram& m_encodeLatency;
+    Core::Counter& m_passthroughFrames;
+    Core::Histogram& m_writeLatency;
+    Core::Histogram& m_sentAge;
+    Core::Counter& m_backlogDrops;
 };
 
 }
\ No newline at end of file
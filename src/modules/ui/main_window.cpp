@@ -16,7 +16,7 @@
 #include <opencv2/opencv.hpp>
 
 #include "modules/ui/main_window.h"
-#include "core/video_capture.h"
+#include "core/camera_manager.h"
 #include "core/video_processor.h"
 #include "modules/network/network_server.h"
 #include "arctic_owl/version.h"
@@ -30,6 +30,8 @@ MainWindow::MainWindow(QWidget* parent)
     , m_videoLabel(nullptr)
     , m_startButton(nullptr)
     , m_stopButton(nullptr)
+    , m_addCameraButton(nullptr)
+    , m_removeCameraButton(nullptr)
     , m_intrusionCheckBox(nullptr)
     , m_fireCheckBox(nullptr)
     , m_motionCheckBox(nullptr)
@@ -37,6 +39,7 @@ MainWindow::MainWindow(QWidget* parent)
     , m_camerasTable(nullptr)
     , m_cameraIdSpinBox(nullptr)
     , m_alertsTimer(nullptr)
+    , m_camerasTimer(nullptr)
     , m_cameraSourceCombo(nullptr)
     , m_controlGroup(nullptr)
     , m_cameraGroup(nullptr)
@@ -53,20 +56,22 @@ MainWindow::MainWindow(QWidget* parent)
     , m_languageEnglishAction(nullptr)
     , m_languageChineseAction(nullptr)
     , m_languageActionGroup(nullptr)
-    , m_videoCapture(nullptr)
-    , m_videoProcessor(nullptr)
+    , m_cameraManager(nullptr)
     , m_networkServer(nullptr)
 {
+    m_displayedAge = &Core::MetricsRegistry::instance().histogram(
+        "arcticowl_frame_age_seconds", "Time from grab() until a frame reaches a stage.",
+        Core::MetricsRegistry::label("stage", "displayed"));
+
     setupUI();
 
     m_alertsTimer = new QTimer(this);
     m_alertsTimer->setInterval(m_alertIntervalMs);
     connect(m_alertsTimer, &QTimer::timeout, this, &MainWindow::updateAlerts);
 
-    if (m_videoCapture) {
-        connect(m_videoCapture, &Core::VideoCapture::frameReady,
-                this, &MainWindow::updateFrame, Qt::QueuedConnection);
-    }
+    m_camerasTimer = new QTimer(this);
+    m_camerasTimer->setInterval(1000);
+    connect(m_camerasTimer, &QTimer::timeout, this, &MainWindow::updateCamerasTable);
 
     retranslateUi();
     updateActionChecks();
@@ -130,6 +135,13 @@ void MainWindow::setupUI()
     sourceLayout->addWidget(m_cameraSourceCombo);
     cameraLayout->addLayout(sourceLayout);
 
+    auto* cameraButtonLayout = new QHBoxLayout();
+    m_addCameraButton = new QPushButton(this);
+    m_removeCameraButton = new QPushButton(this);
+    cameraButtonLayout->addWidget(m_addCameraButton);
+    cameraButtonLayout->addWidget(m_removeCameraButton);
+    cameraLayout->addLayout(cameraButtonLayout);
+
     controlLayout->addWidget(m_cameraGroup);
 
     m_detectionGroup = new QGroupBox(this);
@@ -173,12 +185,19 @@ void MainWindow::setupUI()
     m_camerasTableLabel = new QLabel(this);
     mainLayout->addWidget(m_camerasTableLabel);
 
-    m_camerasTable = new QTableWidget(0, 3, this);
-    m_camerasTable->setHorizontalHeaderLabels({QString(), QString(), QString()});
+    m_camerasTable = new QTableWidget(0, 4, this);
+    m_camerasTable->setHorizontalHeaderLabels({QString(), QString(), QString(), QString()});
+    m_camerasTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_camerasTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_camerasTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     mainLayout->addWidget(m_camerasTable);
 
     connect(m_startButton, &QPushButton::clicked, this, &MainWindow::startSystem);
     connect(m_stopButton, &QPushButton::clicked, this, &MainWindow::stopSystem);
+    connect(m_addCameraButton, &QPushButton::clicked, this, &MainWindow::addCamera);
+    connect(m_removeCameraButton, &QPushButton::clicked, this, &MainWindow::removeCamera);
+    connect(m_camerasTable, &QTableWidget::currentCellChanged,
+            this, &MainWindow::onCameraSelectionChanged);
 }
 
 void MainWindow::retranslateUi()
@@ -210,6 +229,12 @@ void MainWindow::retranslateUi()
     if (m_stopButton) {
         m_stopButton->setText(tr("Stop System"));
     }
+    if (m_addCameraButton) {
+        m_addCameraButton->setText(tr("Add Camera"));
+    }
+    if (m_removeCameraButton) {
+        m_removeCameraButton->setText(tr("Remove Camera"));
+    }
 
     if (m_controlGroup) {
         m_controlGroup->setTitle(tr("System Control"));
@@ -254,7 +279,9 @@ void MainWindow::retranslateUi()
         m_camerasTable->setHorizontalHeaderLabels({
             tr("ID"),
             tr("Location"),
-            tr("Status")});
+            tr("Status"),
+            tr("FPS")});
+        updateCamerasTable();
     }
 
     if (m_settingsMenu) {
@@ -382,6 +409,20 @@ void MainWindow::openSettingsDialog()
     portSpin->setValue(m_networkPort);
     layout->addRow(tr("Network Port:"), portSpin);
 
+    auto* metricsPortSpin = new QSpinBox(&dialog);
+    metricsPortSpin->setRange(0, 65535);
+    metricsPortSpin->setSpecialValueText(tr("Disabled"));
+    metricsPortSpin->setValue(m_metricsPort);
+    layout->addRow(tr("Metrics Port:"), metricsPortSpin);
+
+    auto* analysisScaleCombo = new QComboBox(&dialog);
+    analysisScaleCombo->addItem(tr("Native resolution"), 1.0);
+    analysisScaleCombo->addItem(tr("1/2 resolution"), 0.5);
+    analysisScaleCombo->addItem(tr("1/4 resolution"), 0.25);
+    const int scaleIndex = analysisScaleCombo->findData(m_analysisScale);
+    analysisScaleCombo->setCurrentIndex(scaleIndex >= 0 ? scaleIndex : 0);
+    layout->addRow(tr("Analysis Resolution:"), analysisScaleCombo);
+
     auto* intervalSpin = new QSpinBox(&dialog);
     intervalSpin->setRange(200, 10000);
     intervalSpin->setSingleStep(100);
@@ -394,15 +435,20 @@ void MainWindow::openSettingsDialog()
     connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
 
     if (dialog.exec() == QDialog::Accepted) {
-        const bool portChanged = (m_networkPort != portSpin->value());
+        const bool portChanged = (m_networkPort != portSpin->value() || m_metricsPort != metricsPortSpin->value());
         m_networkPort = portSpin->value();
+        m_metricsPort = metricsPortSpin->value();
         m_alertIntervalMs = intervalSpin->value();
+        m_analysisScale = analysisScaleCombo->currentData().toDouble();
+        if (m_cameraManager) {
+            m_cameraManager->setAnalysisScale(m_analysisScale);
+        }
         m_alertsTimer->setInterval(m_alertIntervalMs);
 
         if (m_systemRunning && portChanged) {
             QMessageBox::information(this,
                                      tr("Settings Updated"),
-                                     tr("The network port will take effect the next time the system starts."));
+                                     tr("The network ports will take effect the next time the system starts."));
         }
     }
 }
@@ -419,43 +465,75 @@ void MainWindow::showAboutDialog()
     QMessageBox::about(this, tr("About ArcticOwl"), aboutText);
 }
 
+Core::CameraManager::CameraSource MainWindow::promptCameraSource()
+{
+    Core::CameraManager::CameraSource source;
+
+    int sourceIndex = m_cameraSourceCombo->currentIndex();
+    if (sourceIndex == 0) {
+        source.cameraId = m_cameraIdSpinBox->value();
+    } else if (sourceIndex == 1) {
+        QString rtspUrl = QInputDialog::getText(this,
+                                               tr("RTSP Stream URL"),
+                                               tr("Enter the RTSP stream URL:"));
+        if (rtspUrl.isEmpty()) {
+            throw std::runtime_error(tr("RTSP stream URL cannot be empty.").toUtf8().toStdString());
+        }
+        source.rtspUrl = rtspUrl.toStdString();
+    } else if (sourceIndex == 2) {
+        QString rtmpUrl = QInputDialog::getText(this,
+                                               tr("RTMP Stream URL"),
+                                               tr("Enter the RTMP stream URL:"));
+        if (rtmpUrl.isEmpty()) {
+            throw std::runtime_error(tr("RTMP stream URL cannot be empty.").toUtf8().toStdString());
+        }
+        source.rtmpUrl = rtmpUrl.toStdString();
+    }
+
+    return source;
+}
+
 void MainWindow::initializeSystem()
 {
     try {
-        int sourceIndex = m_cameraSourceCombo->currentIndex();
-        if (sourceIndex == 0) {
-            m_videoCapture = new Core::VideoCapture(nullptr, m_cameraIdSpinBox->value());
-        } else if (sourceIndex == 1) {
-            QString rtspUrl = QInputDialog::getText(this,
-                                                   tr("RTSP Stream URL"),
-                                                   tr("Enter the RTSP stream URL:"));
-            if (rtspUrl.isEmpty()) {
-                throw std::runtime_error(tr("RTSP stream URL cannot be empty.").toUtf8().toStdString());
-            }
-            m_videoCapture = new Core::VideoCapture(nullptr, -1, rtspUrl.toStdString());
-        } else if (sourceIndex == 2) {
-            QString rtmpUrl = QInputDialog::getText(this,
-                                                   tr("RTMP Stream URL"),
-                                                   tr("Enter the RTMP stream URL:"));
-            if (rtmpUrl.isEmpty()) {
-                throw std::runtime_error(tr("RTMP stream URL cannot be empty.").toUtf8().toStdString());
-            }
-            m_videoCapture = new Core::VideoCapture(nullptr, -1, "", rtmpUrl.toStdString());
+        if (m_cameraSources.empty()) {
+            m_cameraSources.push_back(promptCameraSource());
+            updateCamerasTable();
         }
 
-        m_videoProcessor = new Core::VideoProcessor();
-        m_networkServer = new Network::NetworkServer(m_networkPort);
+        m_cameraManager = new Core::CameraManager();
+        for (const auto& source : m_cameraSources) {
+            m_cameraManager->addCamera(source);
+        }
+
+        m_cameraManager->setIntrusionDetection(m_intrusionCheckBox->isChecked());
+        m_cameraManager->setFireDetection(m_fireCheckBox->isChecked());
+        m_cameraManager->setMotionDetection(m_motionCheckBox->isChecked());
+        m_cameraManager->setAnalysisScale(m_analysisScale);
 
-        if (m_videoProcessor) {
-            m_videoProcessor->setIntrusionDetection(m_intrusionCheckBox->isChecked());
-            m_videoProcessor->setFireDetection(m_fireCheckBox->isChecked());
-            m_videoProcessor->setMotionDetection(m_motionCheckBox->isChecked());
+        int previewCamera = m_camerasTable->currentRow();
+        if (previewCamera < 0 || previewCamera >= static_cast<int>(m_cameraSources.size())) {
+            previewCamera = 0;
         }
+        m_cameraManager->setPreviewCamera(previewCamera);
 
-        if (m_videoCapture) {
-            connect(m_videoCapture, &Core::VideoCapture::frameReady,
-                    this, &MainWindow::updateFrame, Qt::QueuedConnection);
+        m_networkServer = new Network::NetworkServer(m_networkPort);
+        if (m_metricsPort > 0) {
+            m_networkServer->enableMetricsEndpoint(static_cast<unsigned short>(m_metricsPort));
         }
+
+        // The TCP stream carries the previewed camera only.
+        Network::NetworkServer* networkServer = m_networkServer;
+        Core::CameraManager* cameraManager = m_cameraManager;
+        m_cameraManager->setFrameSink([networkServer, cameraManager](const Core::Frame& annotatedFrame,
+                                                                     const std::vector<Core::VideoProcessor::DetectionResult>&) {
+            if (annotatedFrame.cameraIndex == cameraManager->previewCamera()) {
+                networkServer->broadcastFrame(annotatedFrame);
+            }
+        });
+
+        connect(m_cameraManager, &Core::CameraManager::frameProcessed,
+                this, &MainWindow::updateFrame);
     } catch (const std::exception& e) {
         std::cerr << "Failed to initialize system: " << e.what() << std::endl;
         QMessageBox::critical(this,
@@ -474,15 +552,10 @@ void MainWindow::initializeSystem()
 void MainWindow::cleanupSystem()
 {
     try {
-        if (m_videoCapture) {
-            m_videoCapture->stopVideoCaptureSystem();
-            delete m_videoCapture;
-            m_videoCapture = nullptr;
-        }
-
-        if (m_videoProcessor) {
-            delete m_videoProcessor;
-            m_videoProcessor = nullptr;
+        if (m_cameraManager) {
+            m_cameraManager->stopCameraSystem();
+            delete m_cameraManager;
+            m_cameraManager = nullptr;
         }
 
         if (m_networkServer) {
@@ -504,7 +577,7 @@ void MainWindow::startSystem()
     try {
         initializeSystem();
 
-        if (m_videoCapture && !m_videoCapture->startVideoCaptureSystem()) {
+        if (m_cameraManager && !m_cameraManager->startCameraSystem()) {
             QMessageBox::critical(this,
                                   tr("Error"),
                                   tr("Failed to start the camera."));
@@ -520,8 +593,12 @@ void MainWindow::startSystem()
         m_hasEverStarted = true;
         m_startButton->setEnabled(false);
         m_stopButton->setEnabled(true);
+        m_addCameraButton->setEnabled(false);
+        m_removeCameraButton->setEnabled(false);
 
         m_alertsTimer->start(m_alertIntervalMs);
+        m_camerasTimer->start();
+        updateCamerasTable();
 
         if (m_videoLabel->pixmap().isNull()) {
             m_videoLabel->setText(tr("Acquiring video stream..."));
@@ -557,11 +634,15 @@ void MainWindow::stopSystem()
 
     try {
         m_alertsTimer->stop();
+        m_camerasTimer->stop();
         cleanupSystem();
         
         m_systemRunning = false;
         m_startButton->setEnabled(true);
         m_stopButton->setEnabled(false);
+        m_addCameraButton->setEnabled(true);
+        m_removeCameraButton->setEnabled(true);
+        updateCamerasTable();
         m_videoLabel->clear();
         m_videoLabel->setText(tr("System stopped."));
     } catch (const std::exception& e) {
@@ -577,43 +658,27 @@ void MainWindow::stopSystem()
     }
 }
 
-void MainWindow::updateFrame(const cv::Mat& frame)
+void MainWindow::updateFrame(const Core::Frame& annotatedFrame)
 {
     try {
-        if (frame.empty()) {
+        if (annotatedFrame.empty() || !m_cameraManager
+            || annotatedFrame.cameraIndex != m_cameraManager->previewCamera()) {
             return;
         }
 
-        cv::Mat processedFrame = frame.clone();
-
-        if (m_videoProcessor) {
-            auto results = m_videoProcessor->processFrame(frame);
-            for (const auto& r : results) {
-                cv::Scalar color(0, 255, 0);
-                if (r.type == Core::VideoProcessor::DetectionResult::FIRE) color = cv::Scalar(0, 0, 255);
-                if (r.type == Core::VideoProcessor::DetectionResult::INTRUSION) color = cv::Scalar(255, 0, 0);
-                cv::rectangle(processedFrame, r.boundingBox, color, 2);
-                std::string label = r.description + " (" + std::to_string(r.confidence) + ")";
-                cv::Point textOrg(r.boundingBox.x, std::max(0, r.boundingBox.y - 5));
-                cv::putText(processedFrame, label, textOrg, cv::FONT_HERSHEY_SIMPLEX, 0.5, color, 1);
-            }
-        }
-
-        if (m_networkServer) {
-            m_networkServer->broadcastFrame(processedFrame);
-        }
+        const cv::Mat& frame = annotatedFrame.image;
 
-        cv::Mat rgbFrame;
-        if (processedFrame.channels() == 3) {
-            cv::cvtColor(processedFrame, rgbFrame, cv::COLOR_BGR2RGB);
+        if (frame.channels() == 3) {
+            cv::cvtColor(frame, m_rgbFrame, cv::COLOR_BGR2RGB);
         } else {
-            cv::cvtColor(processedFrame, rgbFrame, cv::COLOR_GRAY2RGB);
+            cv::cvtColor(frame, m_rgbFrame, cv::COLOR_GRAY2RGB);
         }
-        QImage qimg(rgbFrame.data, rgbFrame.cols, rgbFrame.rows,
-                    static_cast<int>(rgbFrame.step), QImage::Format_RGB888);
+        QImage qimg(m_rgbFrame.data, m_rgbFrame.cols, m_rgbFrame.rows,
+                    static_cast<int>(m_rgbFrame.step), QImage::Format_RGB888);
 
         m_videoLabel->setPixmap(QPixmap::fromImage(qimg).scaled(
             m_videoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        m_displayedAge->observe(annotatedFrame.age());
     } catch (const cv::Exception& e) {
         std::cerr << "OpenCV error: " << e.what() << std::endl;
         QMetaObject::invokeMethod(this, "stopSystem", Qt::QueuedConnection);
@@ -641,11 +706,104 @@ void MainWindow::updateAlerts()
     }
 }
 
+void MainWindow::updateCamerasTable()
+{
+    if (!m_camerasTable) {
+        return;
+    }
+
+    std::vector<Core::CameraManager::CameraStatus> statuses;
+    if (m_cameraManager) {
+        statuses = m_cameraManager->cameraStatuses();
+    }
+
+    auto setCell = [this](int row, int column, const QString& text) {
+        QTableWidgetItem* item = m_camerasTable->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            m_camerasTable->setItem(row, column, item);
+        }
+        item->setText(text);
+    };
+
+    const int rowCount = static_cast<int>(m_cameraSources.size());
+    m_camerasTable->setRowCount(rowCount);
+
+    for (int row = 0; row < rowCount; ++row) {
+        QString status = m_hasEverStarted ? tr("Stopped") : tr("Idle");
+        QString fps = QStringLiteral("-");
+
+        if (row < static_cast<int>(statuses.size())) {
+            const auto& cameraStatus = statuses[row];
+            switch (cameraStatus.state) {
+            case Core::CameraManager::CameraStatus::RUNNING:
+                status = tr("Running");
+                fps = QString::number(cameraStatus.fps, 'f', 1);
+                break;
+            case Core::CameraManager::CameraStatus::RECONNECTING:
+                status = tr("Reconnecting");
+                break;
+            case Core::CameraManager::CameraStatus::FAILED:
+                status = tr("Failed");
+                break;
+            case Core::CameraManager::CameraStatus::STOPPED:
+                status = tr("Stopped");
+                break;
+            case Core::CameraManager::CameraStatus::IDLE:
+                status = tr("Idle");
+                break;
+            }
+        }
+
+        setCell(row, 0, QString::number(row));
+        setCell(row, 1, QString::fromStdString(Core::CameraManager::describeSource(m_cameraSources[row])));
+        setCell(row, 2, status);
+        setCell(row, 3, fps);
+    }
+}
+
+void MainWindow::addCamera()
+{
+    if (m_systemRunning) {
+        return;
+    }
+
+    try {
+        m_cameraSources.push_back(promptCameraSource());
+        updateCamerasTable();
+        m_camerasTable->setCurrentCell(static_cast<int>(m_cameraSources.size()) - 1, 0);
+    } catch (const std::exception& e) {
+        QMessageBox::warning(this, tr("Warning"), QString::fromUtf8(e.what()));
+    }
+}
+
+void MainWindow::removeCamera()
+{
+    if (m_systemRunning) {
+        return;
+    }
+
+    const int row = m_camerasTable->currentRow();
+    if (row < 0 || row >= static_cast<int>(m_cameraSources.size())) {
+        return;
+    }
+
+    m_cameraSources.erase(m_cameraSources.begin() + row);
+    updateCamerasTable();
+}
+
+void MainWindow::onCameraSelectionChanged(int currentRow, int, int, int)
+{
+    if (m_cameraManager && currentRow >= 0 && currentRow < static_cast<int>(m_cameraManager->cameraCount())) {
+        m_cameraManager->setPreviewCamera(currentRow);
+    }
+}
+
 void MainWindow::onIntrusionDetectionChanged(bool enabled)
 {
     try {
-        if (m_videoProcessor) {
-            m_videoProcessor->setIntrusionDetection(enabled);
+        if (m_cameraManager) {
+            m_cameraManager->setIntrusionDetection(enabled);
         }
     } catch (const std::exception& e) {
         std::cerr << "Failed to toggle intrusion detection: " << e.what() << std::endl;
@@ -657,8 +815,8 @@ void MainWindow::onIntrusionDetectionChanged(bool enabled)
 void MainWindow::onFireDetectionChanged(bool enabled)
 {
     try {
-        if (m_videoProcessor) {
-            m_videoProcessor->setFireDetection(enabled);
+        if (m_cameraManager) {
+            m_cameraManager->setFireDetection(enabled);
         }
     } catch (const std::exception& e) {
         std::cerr << "Failed to toggle fire detection: " << e.what() << std::endl;
@@ -670,8 +828,8 @@ void MainWindow::onFireDetectionChanged(bool enabled)
 void MainWindow::onMotionDetectionChanged(bool enabled)
 {
     try {
-        if (m_videoProcessor) {
-            m_videoProcessor->setMotionDetection(enabled);
+        if (m_cameraManager) {
+            m_cameraManager->setMotionDetection(enabled);
         }
     } catch (const std::exception& e) {
         std::cerr << "Failed to toggle motion detection: " << e.what() << std::endl;
@@ -24,7 +24,11 @@
 #include <QTranslator>
 #include <opencv2/opencv.hpp>
 
-#include "core/video_capture.h"
+#include <vector>
+
+#include "core/camera_manager.h"
+#include "core/frame.h"
+#include "core/metrics.h"
 #include "core/video_processor.h"
 
 namespace ArcticOwl::Modules::Network {
@@ -47,8 +51,13 @@ private slots:
     void startSystem();
     void stopSystem();
 
-    void updateFrame(const cv::Mat& frame);
+    void updateFrame(const ArcticOwl::Core::Frame& annotatedFrame);
     void updateAlerts();
+    void updateCamerasTable();
+
+    void addCamera();
+    void removeCamera();
+    void onCameraSelectionChanged(int currentRow, int currentColumn, int previousRow, int previousColumn);
 
     void onIntrusionDetectionChanged(bool enabled);
     void onFireDetectionChanged(bool enabled);
@@ -65,6 +74,7 @@ private:
 
     void initializeSystem();
     void cleanupSystem();
+    Core::CameraManager::CameraSource promptCameraSource();
 
     void setupUI();
     void setupMenus();
@@ -81,6 +91,8 @@ private:
     QLabel* m_videoLabel;
     QPushButton* m_startButton;
     QPushButton* m_stopButton;
+    QPushButton* m_addCameraButton;
+    QPushButton* m_removeCameraButton;
     QCheckBox* m_intrusionCheckBox;
     QCheckBox* m_fireCheckBox;
     QCheckBox* m_motionCheckBox;
@@ -88,6 +100,7 @@ private:
     QTableWidget* m_camerasTable;
     QSpinBox* m_cameraIdSpinBox;
     QTimer* m_alertsTimer;
+    QTimer* m_camerasTimer;
     QComboBox* m_cameraSourceCombo;
     QGroupBox* m_controlGroup;
     QGroupBox* m_cameraGroup;
@@ -107,13 +120,18 @@ private:
     QActionGroup* m_languageActionGroup;
 
     int m_networkPort = 8080;
+    int m_metricsPort = 9464;
+    double m_analysisScale = 1.0;
     int m_alertIntervalMs = 1000;
 
     Language m_currentLanguage = Language::English;
     QTranslator m_translator;
 
-    Core::VideoCapture* m_videoCapture;
-    Core::VideoProcessor* m_videoProcessor;
+    cv::Mat m_rgbFrame;
+    Core::Histogram* m_displayedAge;
+
+    std::vector<Core::CameraManager::CameraSource> m_cameraSources;
+    Core::CameraManager* m_cameraManager;
     Network::NetworkServer* m_networkServer;
 };
 
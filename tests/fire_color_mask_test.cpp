@@ -0,0 +1,127 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "core/fire_color_mask.h"
+
+// Checks Core::fireColorMask against the cvtColor/inRange/bitwise_or chain
+// it replaces. Exits non-zero on the first image where the two differ.
+
+namespace {
+
+void referenceFireColorMask(const cv::Mat& frame, cv::Mat& mask)
+{
+    cv::Mat hsv, lower, upper;
+    cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, cv::Scalar(0, 100, 100), cv::Scalar(15, 255, 255), lower);
+    cv::inRange(hsv, cv::Scalar(160, 100, 100), cv::Scalar(180, 255, 255), upper);
+    cv::bitwise_or(lower, upper, mask);
+}
+
+bool matches(const cv::Mat& frame, const std::string& name)
+{
+    cv::Mat fused, expected;
+    ArcticOwl::Core::fireColorMask(frame, fused);
+    referenceFireColorMask(frame, expected);
+
+    if (fused.size() != expected.size() || fused.type() != expected.type()) {
+        std::cerr << name << ": mask is " << fused.cols << "x" << fused.rows << ", expected "
+                  << expected.cols << "x" << expected.rows << std::endl;
+        return false;
+    }
+
+    for (int y = 0; y < frame.rows; ++y) {
+        for (int x = 0; x < frame.cols; ++x) {
+            if (fused.at<uchar>(y, x) != expected.at<uchar>(y, x)) {
+                const cv::Vec3b bgr = frame.at<cv::Vec3b>(y, x);
+                std::cerr << name << ": pixel (" << x << ", " << y << ") BGR " << int(bgr[0]) << ","
+                          << int(bgr[1]) << "," << int(bgr[2]) << " gives " << int(fused.at<uchar>(y, x))
+                          << ", expected " << int(expected.at<uchar>(y, x)) << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Every BGR value once. The odd width leaves a scalar tail on every row.
+bool checkAllColors()
+{
+    constexpr int kColors = 1 << 24;
+    constexpr int kWidth = 4093;
+    cv::Mat colors((kColors + kWidth - 1) / kWidth, kWidth, CV_8UC3, cv::Scalar::all(0));
+    for (int value = 0; value < kColors; ++value) {
+        colors.at<cv::Vec3b>(value / kWidth, value % kWidth) =
+            cv::Vec3b(static_cast<uchar>(value), static_cast<uchar>(value >> 8), static_cast<uchar>(value >> 16));
+    }
+    return matches(colors, "all colours");
+}
+
+// Colours on both sides of the hue (15/16, 159/160, wrap at 180) and S/V
+// (99/100) bounds, converted from HSV so they land next to the thresholds.
+bool checkBoundaries()
+{
+    std::vector<cv::Vec3b> hsvValues;
+    for (int h = 0; h < 180; ++h) {
+        for (int s : {0, 98, 99, 100, 101, 102, 254, 255}) {
+            for (int v : {0, 98, 99, 100, 101, 102, 254, 255}) {
+                hsvValues.emplace_back(static_cast<uchar>(h), static_cast<uchar>(s), static_cast<uchar>(v));
+            }
+        }
+    }
+    const cv::Mat hsv(1, static_cast<int>(hsvValues.size()), CV_8UC3, hsvValues.data());
+    cv::Mat bgr;
+    cv::cvtColor(hsv, bgr, cv::COLOR_HSV2BGR);
+
+    // Neighbours of every converted colour, one channel step either way.
+    cv::Mat neighbours(7, bgr.cols, CV_8UC3);
+    for (int x = 0; x < bgr.cols; ++x) {
+        const cv::Vec3b centre = bgr.at<cv::Vec3b>(0, x);
+        neighbours.at<cv::Vec3b>(0, x) = centre;
+        for (int channel = 0; channel < 3; ++channel) {
+            cv::Vec3b lower = centre;
+            cv::Vec3b upper = centre;
+            lower[channel] = cv::saturate_cast<uchar>(lower[channel] - 1);
+            upper[channel] = cv::saturate_cast<uchar>(upper[channel] + 1);
+            neighbours.at<cv::Vec3b>(1 + 2 * channel, x) = lower;
+            neighbours.at<cv::Vec3b>(2 + 2 * channel, x) = upper;
+        }
+    }
+    return matches(neighbours, "hue/saturation/value boundaries");
+}
+
+// Random images at every width up to a few vector lengths, so each length
+// of scalar tail is covered, plus a non-continuous ROI.
+bool checkRandomImages()
+{
+    cv::RNG rng(0x0f17e);
+    for (int width = 1; width <= 70; ++width) {
+        cv::Mat frame(9, width, CV_8UC3);
+        rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+        if (!matches(frame, "random " + std::to_string(width) + "x9")) {
+            return false;
+        }
+    }
+
+    // Red-dominant pixels, which take the full test instead of the early out.
+    cv::Mat reddish(480, 641, CV_8UC3);
+    rng.fill(reddish, cv::RNG::UNIFORM, cv::Scalar(0, 0, 90), cv::Scalar(140, 140, 256));
+    if (!matches(reddish, "reddish 641x480")) {
+        return false;
+    }
+
+    cv::Mat large(1083, 1925, CV_8UC3);
+    rng.fill(large, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    return matches(large(cv::Rect(3, 1, 1917, 1080)), "ROI 1917x1080");
+}
+
+}
+
+int main()
+{
+    const bool passed = checkBoundaries() && checkRandomImages() && checkAllColors();
+    std::cout << (passed ? "fireColorMask matches cvtColor/inRange" : "fireColorMask differs from cvtColor/inRange")
+              << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "core/gradient_energy.h"
+
+// Checks Core::GradientEnergyMap against the whole-frame cv::Sobel magnitude
+// it approximates in single precision. Exits non-zero on the first mean that
+// differs by more than kTolerance.
+
+namespace {
+
+constexpr double kTolerance = 1e-3;
+
+cv::Mat referenceMagnitude(const cv::Mat& image)
+{
+    // A fresh grey image, so Sobel reflects at the edges of an ROI instead
+    // of reading its parent, as the map does.
+    cv::Mat gray, gradX, gradY, magnitude;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        image.copyTo(gray);
+    }
+    cv::Sobel(gray, gradX, CV_64F, 1, 0, 3);
+    cv::Sobel(gray, gradY, CV_64F, 0, 1, 3);
+    cv::magnitude(gradX, gradY, magnitude);
+    return magnitude;
+}
+
+bool meanMatches(const ArcticOwl::Core::GradientEnergyMap& map, const cv::Mat& magnitude, const cv::Rect& box,
+                 const std::string& name)
+{
+    const cv::Rect clipped = box & map.area();
+    const double expected = clipped.empty() ? 0.0 : cv::mean(magnitude(clipped))[0];
+    const double actual = map.meanMagnitude(box);
+    if (std::abs(actual - expected) > kTolerance) {
+        std::cerr << name << ": box " << box << " in area " << map.area() << " has mean " << actual
+                  << ", expected " << expected << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Every pixel of the area on its own, then random boxes, including ones
+// that stick out of the area.
+bool areaMatches(const cv::Mat& image, const cv::Rect& area, cv::RNG& rng, const std::string& name)
+{
+    const cv::Mat magnitude = referenceMagnitude(image);
+    ArcticOwl::Core::GradientEnergyMap map;
+    map.compute(image, area);
+
+    const cv::Rect& clipped = map.area();
+    for (int y = clipped.y; y < clipped.y + clipped.height; ++y) {
+        for (int x = clipped.x; x < clipped.x + clipped.width; ++x) {
+            if (!meanMatches(map, magnitude, cv::Rect(x, y, 1, 1), name)) {
+                return false;
+            }
+        }
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        const int x = rng.uniform(-4, image.cols);
+        const int y = rng.uniform(-4, image.rows);
+        const cv::Rect box(x, y, rng.uniform(1, image.cols + 8), rng.uniform(1, image.rows + 8));
+        if (!meanMatches(map, magnitude, box, name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whole images at every width up to a few vector lengths, so each length of
+// scalar tail is covered, in colour and grey.
+bool checkWholeImages(cv::RNG& rng)
+{
+    for (int width = 2; width <= 40; ++width) {
+        cv::Mat frame(7, width, CV_8UC3);
+        rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+        const cv::Rect whole(0, 0, frame.cols, frame.rows);
+        if (!areaMatches(frame, whole, rng, "BGR " + std::to_string(width) + "x7")) {
+            return false;
+        }
+
+        cv::Mat gray;
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        if (!areaMatches(gray, whole, rng, "grey " + std::to_string(width) + "x7")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Areas inside the image, on its edges, and partly outside it: the border
+// must come from the neighbouring pixels where they exist and be reflected
+// where they do not, as in the whole-frame Sobel.
+bool checkAreas(cv::RNG& rng)
+{
+    cv::Mat frame(97, 131, CV_8UC3);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    // Extreme gradients, as on hard black/white edges.
+    frame(cv::Rect(40, 30, 21, 17)).setTo(cv::Scalar::all(255));
+    frame(cv::Rect(60, 30, 3, 40)).setTo(cv::Scalar::all(0));
+
+    const std::vector<cv::Rect> areas = {
+        {0, 0, 131, 97},     {1, 1, 129, 95},   {0, 0, 17, 13},   {114, 84, 17, 13},
+        {35, 25, 33, 29},    {50, 0, 1, 97},    {0, 50, 131, 1},  {-10, -10, 40, 40},
+        {120, 90, 50, 50},   {64, 48, 1, 1},
+    };
+    for (const auto& area : areas) {
+        std::ostringstream name;
+        name << "area " << area;
+        if (!areaMatches(frame, area, rng, name.str())) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < 32; ++i) {
+        const cv::Rect area(rng.uniform(0, frame.cols), rng.uniform(0, frame.rows),
+                            rng.uniform(1, frame.cols), rng.uniform(1, frame.rows));
+        if (!areaMatches(frame, area, rng, "random area " + std::to_string(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Large enough to be split into stripes, and a non-continuous ROI.
+bool checkLargeImage(cv::RNG& rng)
+{
+    cv::Mat large(1084, 1923, CV_8UC3);
+    rng.fill(large, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::GaussianBlur(large, large, cv::Size(5, 5), 0);
+    const cv::Mat frame = large(cv::Rect(1, 2, 1921, 1080));
+
+    const cv::Mat magnitude = referenceMagnitude(frame);
+    ArcticOwl::Core::GradientEnergyMap map;
+    map.compute(frame, cv::Rect(0, 0, frame.cols, frame.rows));
+    for (int i = 0; i < 256; ++i) {
+        const cv::Rect box(rng.uniform(0, frame.cols), rng.uniform(0, frame.rows),
+                           rng.uniform(1, frame.cols / 2), rng.uniform(1, frame.rows / 2));
+        if (!meanMatches(map, magnitude, box, "ROI 1921x1080")) {
+            return false;
+        }
+    }
+    return meanMatches(map, magnitude, cv::Rect(0, 0, frame.cols, frame.rows), "ROI 1921x1080");
+}
+
+}
+
+int main()
+{
+    cv::RNG rng(0x50be1);
+    const bool passed = checkWholeImages(rng) && checkAreas(rng) && checkLargeImage(rng);
+    std::cout << (passed ? "GradientEnergyMap matches cv::Sobel" : "GradientEnergyMap differs from cv::Sobel")
+              << std::endl;
+    return passed ? 0 : 1;
+}
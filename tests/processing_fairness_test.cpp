@@ -0,0 +1,90 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "core/processing_worker.h"
+#include "core/thread_pool.h"
+
+// Runs more cameras than pool threads, each always with a frame waiting, and
+// fails if any camera stops being processed: a camera that keeps the drain
+// token must still take turns with the others.
+
+namespace {
+
+using ArcticOwl::Core::Frame;
+using ArcticOwl::Core::ProcessingWorker;
+
+constexpr std::size_t kThreads = 2;
+constexpr std::size_t kCameras = 8;
+constexpr int kRounds = 5;
+constexpr auto kRound = std::chrono::milliseconds(200);
+// Each frame costs this much, so the pool can serve about a tenth of what
+// the feeder submits and every queue stays full.
+constexpr auto kFrameCost = std::chrono::milliseconds(1);
+constexpr auto kFeedInterval = std::chrono::microseconds(200);
+
+}
+
+int main()
+{
+    // Declared first so the workers, which drain on it, stop before it does.
+    ArcticOwl::Core::ThreadPool pool(kThreads);
+
+    std::vector<std::unique_ptr<ProcessingWorker>> workers;
+    for (std::size_t i = 0; i < kCameras; ++i) {
+        auto worker = std::make_unique<ProcessingWorker>(nullptr, nullptr, 1, &pool);
+        worker->setPreviewEnabled(false);
+        worker->setFrameSink([](const Frame&, const std::vector<ArcticOwl::Core::VideoProcessor::DetectionResult>&) {
+            std::this_thread::sleep_for(kFrameCost);
+        });
+        worker->startProcessingSystem();
+        workers.push_back(std::move(worker));
+    }
+
+    std::atomic<bool> feeding{true};
+    std::thread feeder([&]() {
+        std::uint64_t sequence = 0;
+        while (feeding) {
+            ++sequence;
+            for (std::size_t i = 0; i < kCameras; ++i) {
+                Frame frame;
+                frame.image = cv::Mat(8, 8, CV_8UC3, cv::Scalar::all(0));
+                frame.cameraIndex = static_cast<int>(i);
+                frame.sequence = sequence;
+                frame.captureTime = std::chrono::steady_clock::now();
+                workers[i]->submitFrame(frame);
+            }
+            std::this_thread::sleep_for(kFeedInterval);
+        }
+    });
+
+    bool passed = true;
+    std::vector<std::uint64_t> previous(kCameras, 0);
+    for (int round = 1; round <= kRounds; ++round) {
+        std::this_thread::sleep_for(kRound);
+        for (std::size_t i = 0; i < kCameras; ++i) {
+            const std::uint64_t processed = workers[i]->processedFrames();
+            if (processed <= previous[i]) {
+                std::cout << "Camera " << i << " processed no frames in round " << round << " (" << processed
+                          << " in total)" << std::endl;
+                passed = false;
+            }
+            previous[i] = processed;
+        }
+    }
+
+    feeding = false;
+    feeder.join();
+    for (auto& worker : workers) {
+        worker->stopProcessingSystem();
+    }
+
+    std::cout << (passed ? "Every camera kept being processed" : "Some cameras starved on the shared pool")
+              << std::endl;
+    return passed ? 0 : 1;
+}